@@ -24,10 +24,14 @@
 
 
 void requestEvent() {
+  uint16_t rpm = fanRPM;
+
   Wire1.write(mode); // send (back to the printer) the current mode the enclosure is in
+  Wire1.write(static_cast<uint8_t>(rpm >> 8)); // then the fan speed (RPM), most significant byte first
+  Wire1.write(static_cast<uint8_t>(rpm & 0xFF));
 
   #if DEBUG
-  Serial.printf("Printer requested data. Sending: %u", static_cast<uint8_t>(mode)); // print a debug message over USB
+  Serial.printf("Printer requested data. Sending: %u, %u RPM", static_cast<uint8_t>(mode), rpm); // print a debug message over USB
   #endif
 }
 
@@ -82,11 +86,16 @@ bool parsePrintDone(uint8_t recVal, uint8_t num, bool final) {
   switch (recVal) { // check the received byte
     case 0: // if it is zero
       printDone = false; // remember that the print isn't done
+      needsAttention = false; // and that nothing needs attention
       return true; // tell the calling function that something was set
     
     case 1: // if it is one
       printDone = true; // remember that the print is done
       return true; // tell the calling function something was set
+
+    case 2: // if it is two
+      needsAttention = true; // remember that the printer needs attention
+      return true; // tell the calling function something was set
     
     default: // if it is anything else
       return false; // tell the calling function nothing was set
@@ -111,12 +120,14 @@ bool parseName(uint8_t recVal, uint8_t num, bool final) {
     } // for (uint8_t i = (num + 1); i < 256; i++)
   } // if (final)
 
+  printNameChanged = true; // tell core1 to re-render the name
+
   return true; // tell the calling function that something was set
 } // parseName()
 
 // in development
 bool parseControlMode(uint8_t recVal, uint8_t num, bool final) {
-  if (recVal <= CONTROL_MODE_MANUAL && recVal >= CONTROL_MODE_TEMP) {
+  if (recVal <= CONTROL_MODE_CASCADE && recVal >= CONTROL_MODE_TEMP) {
     controlMode = recVal;
     return true; // something was set
   }
@@ -150,6 +161,110 @@ bool parseFan(uint8_t recVal, uint8_t num, bool final) {
   return true; // something was set
 }
 
+bool parseLightLevel(uint8_t recVal, uint8_t num, bool final) {
+  static lights::Light* zone = nullptr; // the zone being set (from the first data byte)
+
+  switch (num) {
+    case 0: // the zone
+      zone = lightManager.getZone(recVal);
+      return zone != nullptr; // something was set if the zone exists
+
+    case 1: // the level
+      if (zone == nullptr) return false; // nothing was set
+
+      zone->setLevel(recVal);
+      return true; // something was set
+
+    default: // any extra bytes
+      return false; // nothing was set
+  }
+}
+
+bool parseLightFadeTime(uint8_t recVal, uint8_t num, bool final) {
+  static lights::Light* zone = nullptr; // the zone being set (from the first data byte)
+  static uint16_t fadeTime = 0; // the fade time being recieved
+
+  switch (num) {
+    case 0: // the zone
+      zone = lightManager.getZone(recVal);
+      return zone != nullptr; // something was set if the zone exists
+
+    case 1: // the most significant byte of the fade time
+      fadeTime = static_cast<uint16_t>(recVal) << 8;
+      return true;
+
+    case 2: // the least significant byte of the fade time
+      if (zone == nullptr) return false; // nothing was set
+
+      fadeTime |= recVal;
+      zone->setFadeTime(min(fadeTime, static_cast<uint16_t>(MAX_DIMING_TIME)));
+      return true; // something was set
+
+    default: // any extra bytes
+      return false; // nothing was set
+  }
+}
+
+bool parseFanCurve(uint8_t recVal, uint8_t num, bool final) {
+  static uint8_t point = 0; // the point being set (from the first data byte)
+  static uint8_t error = 0; // the error being recieved
+
+  switch (num) {
+    case 0: // the point (or FAN_CURVE_COUNT_BYTE to set the number of points)
+      point = recVal;
+      return (point < FAN_CURVE_MAX_POINTS) || (point == FAN_CURVE_COUNT_BYTE); // something was set if the point exists
+
+    case 1: // the error, or the number of points
+      if (point == FAN_CURVE_COUNT_BYTE) {
+        if ((recVal < 2) || (recVal > FAN_CURVE_MAX_POINTS)) return false; // nothing was set
+
+        fanCurvePoints = recVal;
+        return true; // something was set
+      }
+
+      error = min(recVal, static_cast<uint8_t>(99));
+      return point < FAN_CURVE_MAX_POINTS;
+
+    case 2: // the airflow
+      if (point >= FAN_CURVE_MAX_POINTS) return false; // nothing was set
+
+      fanCurveErrors[point] = error;
+      fanCurveAirflows[point] = (recVal == 0) ? 0 : max(recVal, fans::lowestAirflow(FAN_MIN_RPM, fanMaxRPM)); // an airflow too low to keep the fan turning is raised (0 is off)
+      return true; // something was set
+
+    default: // any extra bytes
+      return false; // nothing was set
+  }
+}
+
+bool parsePIDGains(uint8_t recVal, uint8_t num, bool final) {
+  static uint8_t gain = 0; // the gain being set (from the first data byte)
+  static uint16_t value = 0; // the value being recieved
+
+  switch (num) {
+    case 0: // the gain
+      gain = recVal;
+      return gain <= PID_GAIN_KD; // something was set if the gain exists
+
+    case 1: // the most significant byte of the value
+      value = static_cast<uint16_t>(recVal) << 8;
+      return true;
+
+    case 2: // the least significant byte of the value
+      value = min(static_cast<uint16_t>(value | recVal), static_cast<uint16_t>(MAX_PID_GAIN));
+
+      switch (gain) {
+        case PID_GAIN_KP: pidKp = value; return true;
+        case PID_GAIN_KI: pidKi = value; return true;
+        case PID_GAIN_KD: pidKd = value; return true;
+        default: return false; // nothing was set
+      }
+
+    default: // any extra bytes
+      return false; // nothing was set
+  }
+}
+
 void compatabilityParser(uint8_t recVal) {
   if (recVal < 4) { // if it is 0-3:
     if (recVal == 0) {
@@ -198,7 +313,7 @@ void parseI2C() {
   Serial.printf("parseI2C() called.\n"); // print a debug message over USB
   #endif // end of that IF statement
   
-  static bool (*parsers[])(uint8_t, uint8_t, bool) = {parseMode, parseTemp, parsePrintDone, parseMaxFanSpeed, parseLights, parseName, parseControlMode, parseHeater, parseFan}; // an array of pointers to functions to call
+  static bool (*parsers[])(uint8_t, uint8_t, bool) = {parseMode, parseTemp, parsePrintDone, parseMaxFanSpeed, parseLights, parseName, parseControlMode, parseHeater, parseFan, parseLightLevel, parseLightFadeTime, parseFanCurve, parsePIDGains}; // an array of pointers to functions to call
   constexpr static uint8_t parserCount = sizeof(parsers) / sizeof(parsers[0]); // find the number of parser functions (at compile, not during runtime)
 
   while (I2cBuffer.available()) { // repeat for all commands sent by the printer
@@ -262,6 +377,48 @@ void parseI2C() {
 } // parseI2C()
 
 
+bool servoTick(repeating_timer_t *timer) {
+  static uint8_t servo1Pos = 255; // the last positions written (255 so the first tick writes them)
+  static uint8_t servo2Pos = 255;
+
+  uint32_t now = millis();
+  uint8_t pos1 = servo1Trajectory.getPosition(now);
+  uint8_t pos2 = servo2Trajectory.getPosition(now);
+
+  if (pos1 != servo1Pos) {
+    servo1.write(pos1);
+    servo1Pos = pos1;
+  }
+
+  if (pos2 != servo2Pos) {
+    servo2.write(pos2);
+    servo2Pos = pos2;
+  }
+
+  return true; // keep repeating
+}
+
+bool heaterTick(repeating_timer_t *timer) {
+  static bool h1_isOn = false;
+  static bool h2_isOn = false;
+
+  uint32_t now = millis();
+  bool h1_On = heater1Output.update(now);
+  bool h2_On = heater2Output.update(now);
+
+  digitalWrite(HEATER_1_PIN, !h1_On); // set the value of heater1
+  digitalWrite(HEATER_2_PIN, !h2_On); // set the value of heater2
+
+  if ((h1_On != h1_isOn) || (h2_On != h2_isOn)) { // if we are turning the heaters off or on (if the state of the heaters is changing)
+    mainLight.blip(25000); // bypass a hardware issue? This fixed a bug, so don't change
+  }
+
+  h1_isOn = h1_On;
+  h2_isOn = h2_On;
+
+  return true; // keep repeating
+}
+
 void I2cReceived(int numBytes) {
   while (Wire1.available()) { // write each byte in the buffer to another buffer
     I2cBuffer.write(Wire1.read());
@@ -379,7 +536,9 @@ void losingPower() {
       if (saveStateOnPowerLoss) { // if we are saving the state
        // turn stuff off
         digitalWrite(LIGHTS_PIN, !MAIN_LIGHTS_ON); // turn off the lights
-        digitalWrite(FAN_PIN, !FAN_ON); // turn off the fan
+        digitalWrite(LIGHT_STRIP_PIN, !LIGHT_STRIP_ON); // turn off the light strip
+        fanOutput.write(0); // turn off the fan (its pin is driven by PWM)
+        cancel_repeating_timer(&heaterTimer); // so heaterTick() can't turn the heaters back on
         digitalWrite(HEATER_1_PIN, HIGH); // turn off heater 1
         digitalWrite(HEATER_2_PIN, HIGH); // turn off heater 2
         digitalWrite(PSU_ON_PIN, LOW); // turn off the PSU
@@ -29,7 +29,7 @@
 #include "vars.hpp"
 
 /**
-* @brief the function called on data requested from the printer
+* @brief the function called on data requested from the printer | sends the mode, then the fan's speed in RPM (2 bytes, most significant first)
 */
 void requestEvent();
 
@@ -81,6 +81,26 @@ bool parseHeater(uint8_t recVal, uint8_t num, bool final);
 */
 bool parseFan(uint8_t recVal, uint8_t num, bool final);
 
+/**
+* @brief parses each byte marked as setting the brightness of a light zone (zone, then level)
+*/
+bool parseLightLevel(uint8_t recVal, uint8_t num, bool final);
+
+/**
+* @brief parses each byte marked as setting the fade time of a light zone (zone, then the time in milliseconds, most significant byte first)
+*/
+bool parseLightFadeTime(uint8_t recVal, uint8_t num, bool final);
+
+/**
+* @brief parses each byte marked as setting a point of the fan curve (point, then error, then airflow), or the number of points used (FAN_CURVE_COUNT_BYTE, then the count)
+*/
+bool parseFanCurve(uint8_t recVal, uint8_t num, bool final);
+
+/**
+* @brief parses each byte marked as setting a PID gain (PID_GAIN_*, then the value, most significant byte first)
+*/
+bool parsePIDGains(uint8_t recVal, uint8_t num, bool final);
+
 /**
 * @brief the function called to parse a byte the same as v1 would
 */
@@ -101,6 +121,16 @@ uint8_t available();
 */
 void parseI2C();
 
+/**
+* @brief the repeating timer callback that moves both servos along their trajectories
+*/
+bool servoTick(repeating_timer_t *timer);
+
+/**
+* @brief the repeating timer callback that time-proportions both heaters' demands onto their pins
+*/
+bool heaterTick(repeating_timer_t *timer);
+
 /**
 * @brief the ISR called on I2C data receive. stores all data in a secondary buffer
 */
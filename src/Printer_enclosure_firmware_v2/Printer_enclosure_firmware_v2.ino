@@ -50,6 +50,10 @@ void setup() {
 
   servoSetup();
 
+  fanSetup();
+
+  heaterSetup();
+
   if (!tempSensorSetup()) startupError = true; // try turning on the temp sensors
 
   printerI2cSetup();
@@ -87,6 +91,8 @@ void setup() {
 void setup1() {
   while (!core1StartStartup); // wait for the other core to tell us to start up
 
+  lightSetup(); // set up the lights, and start fading them from this core
+
   if (menuSetup()) { // try seting up the menu
     backupRecovery(); // initialize the menu with the data stored in the simulated EEPROM, if aplicable
 
@@ -156,6 +162,5 @@ void loop1() {
 
   updateScreen(); // update the screen
 
-  printDoneLight.tick(); // update the print done light
-  mainLight.tick(); // update the main lights
+  lightManager.tick(); // update the lights
 }
@@ -32,12 +32,19 @@
 
 #define DEBUG true // sets if debug messages will be sent. set to "true" for debuging messages, and to "false" for none (except if there is an error)
 #define SERIAL_CONTROL false // sets if serial control will be used, and thus if serial should be initialized at the start of the program if debug is false
+#define SCREEN_FRAME_DUMP false // sets if every frame sent to the screen will also be sent over USB as a PBM image (with its render time), so that frames can be compared on a computer | I2C byte counts come from the host display harness in test/display
+#define DISPLAY_STATS false // sets if the screen's render time, display() time, time waiting for I2C, and frame rate will be measured, shown on the bottom line of the screen, and sent over USB every DISPLAY_STATS_INTERVAL ms (along with how long the lights have waited for the PSU)
+#define COUNT_HEAP_ALLOCATIONS false // sets if the number of heap allocations made while drawing each frame will be sent over USB | best used with DEBUG off, as long debug messages allocate their own buffers
+
+#if SCREEN_FRAME_DUMP && DEBUG
+#error "SCREEN_FRAME_DUMP can't be used with DEBUG; the debug messages would be mixed in with the frames"
+#endif
 
 // version info (e.g. 1.2.3 : majorV. = 1, minorV. = 2, bugFixV. = 3)
 constexpr uint8_t majorVersion = 2;
 constexpr uint8_t minorVersion = 1;
 constexpr uint8_t bugFixVersion = 0;
-constexpr uint8_t buildVersion = 18; // this might be useful if you make your own changes to the code
+constexpr uint8_t buildVersion = 33; // this might be useful if you make your own changes to the code
 
 // other
 
@@ -84,25 +91,85 @@ constexpr uint8_t buildVersion = 18; // this might be useful if you make your ow
 
 #define COOLDOWN_SWITCH_HOLD_TIME 5000 ///< the time, in miliseconds, that the cooldown switch needs to be held to trigger a cooldown
 
-#define SCREENSAVER_SPEED 7 ///< the time (in milliseconds) between changes of lit pixel when screensaver displayed
+#define SCREENSAVER_CONTRAST 1 ///< the contrast (0-255) the screen is dimmed to when the screensaver starts
+#define SCREENSAVER_OFF_TIME 300 ///< the time (in seconds) after the screensaver starts that the screen will be turned off completely
+#define SCREENSAVER_PIXEL_SHIFT false ///< if the dimmed image will be moved by one pixel every so often, to spread out burn-in
+#define SCREENSAVER_PIXEL_SHIFT_INTERVAL 60000 ///< the time (in milliseconds) between pixel shifts when the screensaver is dimmed | must be at least one minute
+
+#if SCREENSAVER_PIXEL_SHIFT_INTERVAL < 60000
+#error "SCREENSAVER_PIXEL_SHIFT_INTERVAL must be at least 60000 (one minute)"
+#endif
 
 #define DEFAULT_LIGHTS_ON_ON_DOOR_OPEN true
 #define DEFAULT_SAVE_STATE_ON_POWER_LOSS true
 
 #define DEFAULT_NAME_SCROLL_SPEED 100
+#define NAME_SCROLL_GAP (CHARACTER_WIDTH * 4) ///< the blank space (in pixels) between the end of the print name and the start of it coming around again
 #define DEFAULT_MENU_SCROLL_SPEED 75
 
+#define DEFAULT_GRAPH_WINDOW 60 ///< how much time (in minutes) the temperature graph covers
+#define MIN_GRAPH_WINDOW 10 ///< the shortest window (in minutes) the temperature graph can be set to
+#define MAX_GRAPH_WINDOW 360 ///< the longest window (in minutes) the temperature graph can be set to
+#define GRAPH_SAMPLE_INTERVAL 1000 ///< the time (in milliseconds) between temperature readings for the graph | each column is the average of all the readings taken while it was being filled
+#define GRAPH_MIN_TEMP 0 ///< the temperature at the bottom of the graph
+#define GRAPH_DEGREES_PER_PIXEL 2 ///< the vertical scale of the graph | the graph is 48 pixels tall, so the default shows 0 to 95 deg. c.
+
 #define DEFAULT_FAN_OFF_VAL 0
 #define DEFAULT_FAN_MID_VAL 128
 #define DEFAULT_FAN_ON_VAL 255
 #define DEFAULT_DEFAULT_MAX_FAN_SPEED 255
+#define FAN_PWM_FREQ 25000 ///< the fan's PWM frequency (in Hz) | 4-wire PC fans expect 25 kHz, which is also above hearing
+#define FAN_PWM_BITS 12 ///< the fan's PWM resolution | at most 15, but the system clock only gives so many steps per period (e.g. 125 MHz / 25 kHz = 5000, so 12 bits)
+#define FAN_TACH_PULSES_PER_REV 2 ///< how many tachometer pulses the fan gives each revolution (2 for most PC fans)
+#define FAN_TACH_INTERVAL 500 ///< the time (in milliseconds) tachometer pulses are counted over for each RPM reading (and between fan speed control updates)
+#define DEFAULT_FAN_MAX_RPM 3000 ///< the fan's speed (in RPM) at full duty | the fan on / mid / off values are fractions of this
+#define FAN_RPM_KP 16 ///< the fan speed controller's proportional gain (1/256ths of a duty step per RPM of error)
+#define FAN_RPM_KI 4 ///< the fan speed controller's integral gain (1/256ths of a duty step per RPM of error, per reading)
+#define FAN_STALL_RPM 200 ///< below this speed (in RPM) a fan that should be spinning counts as stalled
+#define FAN_MIN_RPM 300 ///< the slowest (in RPM) the fan is held at by the closed loop; any lower airflow is raised to this, so the fan is never mistaken for stalled | must be above FAN_STALL_RPM, with room for the speed to wobble
+#define FAN_SPIN_DOWN_TIME 10000 ///< the longest (in milliseconds) the vent is held open after the fan is turned off, waiting for it to slow below FAN_STALL_RPM before the flaps close (in case the tachometer never says so) | without FAN_HAS_TACH, the vent is always held open this long
+#define FAN_STALL_TIME 3000 ///< how long (in milliseconds) the fan has to be stalled before it is kickstarted again
+#define FAN_STALL_KICKSTARTS 3 ///< how many times a stalled fan is kickstarted before giving up (and going to error mode)
+#define FAN_KICKSTART_MIN_TIME 100 ///< the shortest (in milliseconds) learning will make the kickstart
+#define FAN_KICKSTART_MAX_TIME 9999 ///< the longest (in milliseconds) the kickstart can be set to, or learning will make it
+#define FAN_KICKSTART_SHRINK 8 ///< each start that works shortens the learned kickstart by 1/<this>
+#define FAN_MIN_DUTY_STEP 8 ///< when the fan stalls once started, the learned minimum duty cycle is set this far (out of 255) above the duty it stalled at
+#define FAN_MIN_DUTY_DECAY_RUNS 5 ///< after this many runs in a row that held the fan at the learned minimum duty without it stalling, the minimum is lowered (so one stall doesn't raise it for good)
+#define FAN_MIN_DUTY_DECAY_STEP 2 ///< how far (out of 255) the learned minimum duty cycle is lowered each time
 
 #define DEFAULT_HYSTERESIS 1
 #define DEFAULT_BIG_DIFF 3
 #define DEFAULT_COOLDOWN_DIFF 3
 
-#define DEFAULT_DIMING_TIME 3
-#define DEFAULT_PDL_DIMING_TIME 5
+#define FAN_CURVE_MAX_POINTS 8 ///< how many points the fan curve can have
+#define DEFAULT_FAN_CURVE_POINTS 6 ///< how many of the fan curve's points are used
+#define DEFAULT_FAN_CURVE_ERRORS {0, 1, 2, 3, 4, 5, 6, 7} ///< how far (deg. c.) the inside temp is above the set temp at each point of the fan curve
+#define DEFAULT_FAN_CURVE_AIRFLOWS {0, 32, 48, 80, 140, 255, 255, 255} ///< the airflow (fraction of fanMaxRPM) at each point of the fan curve | other than 0 (off), keep these above FAN_MIN_RPM (26 at the default max RPM), or they are raised to it
+
+#define DEFAULT_DIMING_TIME 750 ///< the time (in milliseconds) fading the main lights on or off takes
+#define DEFAULT_PDL_DIMING_TIME 1250 ///< the time (in milliseconds) fading the print done light on or off takes
+#define DEFAULT_STRIP_DIMING_TIME 750 ///< the time (in milliseconds) fading the light strip on or off takes
+#define MAX_DIMING_TIME 9999 ///< the longest a fade on or off can be set to take (in milliseconds)
+#define DEFAULT_LIGHT_LEVEL 255 ///< the brightness (0 - 255) of the main lights when on
+#define DEFAULT_PDL_LEVEL 255 ///< the brightness (0 - 255) of the print done light when on
+#define DEFAULT_STRIP_LEVEL 255 ///< the brightness (0 - 255) of the light strip when on
+#define DEFAULT_PDL_PATTERNS true ///< if the print done light shows patterns (done, cooling, attention) instead of just fading on when the print is done
+#define LIGHT_FADE_SLICE 7 ///< the PWM slice used (only) to time light fades | nothing should output PWM on its pins (14 and 15)
+#define LIGHT_FADE_TICK_HZ 1000 ///< how many times a second the light fades are stepped
+#define LIGHT_PWM_BITS 15 ///< the PWM resolution of lights that have a slice to themselves (the main lights and the light strip) | at most 15
+#define LIGHT_PWM_FREQ 1000 ///< the PWM frequency (in Hz) of lights that have a slice to themselves | the print done light shares the fan's slice, so it uses FAN_PWM_FREQ and FAN_PWM_BITS
+
+#if LIGHT_PWM_BITS > 15
+#error "LIGHT_PWM_BITS must be 15 or less"
+#endif
+
+#if FAN_PWM_BITS > 15
+#error "FAN_PWM_BITS must be 15 or less"
+#endif
+
+#if FAN_MIN_RPM <= FAN_STALL_RPM
+#error "FAN_MIN_RPM must be above FAN_STALL_RPM"
+#endif
 
 #define DEFAULT_I2C_TEMP_SENSOR_RES 1
 #define DEFAULT_SENSOR_READS 3
@@ -114,19 +181,51 @@ constexpr uint8_t buildVersion = 18; // this might be useful if you make your ow
 #define DEFAULT_SERVO2_CLOSED 0
 #define DEFAULT_SERVO1_SPEED 1
 #define DEFAULT_SERVO2_SPEED 1
+#define SERVO_ACCELERATION 3600 ///< how fast the servos speed up and slow down (deg. / s / s) | 0 moves them at a constant speed
+#define SERVO_TICK_INTERVAL 20 ///< the time (in milliseconds) between servo position updates (one servo frame)
+#define SERVO_SETTLE_TIME 500 ///< how long (in milliseconds) after their trajectories end the servos are given to catch up, before the vent counts as open / closed and they are detached
 
 #define DEFAULT_BACKUP_INTERVAL 1
 #define DEFAULT_SCREENSAVER_TIME 15
 #define DEFAULT_FAN_KICKSTART_TIME 1000
+#define DEFAULT_FAN_MIN_DUTY 0 ///< the lowest duty cycle (0 - 255) the fan is run at once started | learned if fan start learning is on
+#define DEFAULT_FAN_LEARNING true ///< if the fan's kickstart time and minimum duty cycle are learned from its tachometer | always off without FAN_HAS_TACH
 #define DEFAULT_MENU_BUTTON_HOLD_TIME 750
 
 #define DEFAULT_CONTROL_MODE CONTROL_MODE_TEMP // developmental
 
+#define DEFAULT_PID_KP 150 ///< the PID controller's proportional gain (output, out of PID_OUTPUT_MAX, per deg. c. of error)
+#define DEFAULT_PID_KI 60 ///< the PID controller's integral gain (output per deg. c. of error per minute)
+#define DEFAULT_PID_KD 200 ///< the PID controller's derivative gain (output per deg. c. per minute the inside temp is changing)
+#define MAX_PID_GAIN 9999 ///< the largest any PID gain can be set to
+#define PID_DERIVATIVE_FILTER 4 ///< the PID controller's derivative is averaged over about this many temp readings
+#define AUTOTUNE_RELAY_OUTPUT 1000 ///< the output (out of PID_OUTPUT_MAX) autotuning heats and cools with
+#define AUTOTUNE_HYSTERESIS 2 ///< how far (in 1/8ths of a deg. c.) the inside temp has to cross the set temp before autotuning switches between heating and cooling
+#define AUTOTUNE_CYCLES 4 ///< how many oscillations autotuning measures (after the first)
+#define AUTOTUNE_TIMEOUT 14400000 ///< how long (in milliseconds) autotuning can take before it gives up (and goes back to CONTROL_MODE_TEMP)
+#define DEFAULT_HEATER_WINDOW_TIME 5000 ///< the time (in milliseconds) a heater's demand is spread over (the heater is on for that fraction of each window)
+#define DEFAULT_HEATER_MIN_ON_TIME 1000 ///< the shortest time (in milliseconds) a heater is turned on for, to spare its SSR | shorter on times are saved up for later windows
+#define DEFAULT_HEATER_MIN_OFF_TIME 1000 ///< the shortest time (in milliseconds) a heater is turned off for, to spare its SSR
+#define MIN_HEATER_WINDOW_TIME 1000 ///< the shortest the heater window can be set to
+#define DEFAULT_HEATER_STAGING true ///< if heater 2 is used as a second stage (and the two take turns leading, for even wear)
+#define DEFAULT_STAGE2_DIFF 8 ///< how far (deg. c.) the inside temp has to be below the set temp for both heaters to heat | 0 turns this off
+#define DEFAULT_STAGE2_MIN_RISE 5 ///< if one heater, fully on, warms the enclosure slower than this (in tenths of a deg. c. per minute), both heaters heat | 0 turns this off
+#define STAGE2_RISE_TIME 120000 ///< how long (in milliseconds) one heater has to be fully on before its rise is checked
+#define HEATER_ROTATE_TIME 600000 ///< how much longer (in milliseconds) the leading heater has to have been on than the other before they swap
+#define DEFAULT_HEATER_TEMP_LIMIT 70 ///< the highest (deg. c.) the cascade controller will set the heater's target temp to
+#define HEATER_TEMP_LIMIT_MARGIN 10 ///< how far (deg. c.) below MAX_HEATER_TEMP the heater temp limit has to be, so the cascade controller never trips the error
+#define HEATER_PID_KP 200 ///< the inner (heater temp) controller's proportional gain (demand, out of PID_OUTPUT_MAX, per deg. c. of error)
+#define HEATER_PID_KI 100 ///< the inner controller's integral gain (demand per deg. c. of error per minute)
+#define HEATER_PID_KD 0 ///< the inner controller's derivative gain (demand per deg. c. per minute the heater temp is changing)
+#define HEATER_PID_INTERVAL 1000 ///< the time (in milliseconds) between the inner controller's updates | it reads the heater temp itself each time, since the heater changes much faster than the air (and the limit has to be checked against a fresh reading)
+#define HEATER_TICK_INTERVAL 50 ///< the time (in milliseconds) between updates of the heater outputs | the window is divided into steps this long
+
 // hardware (depends on the hardware you use and how you wired everything)
 
 #define FAN_ON HIGH ///< pin state at which the fan will be on
 #define MAIN_LIGHTS_ON HIGH ///< pin state at which the main lights will be on
 #define PRINT_DONE_LIGHT_ON HIGH ///< pin state at which the print done light will be on
+#define LIGHT_STRIP_ON HIGH ///< pin state at which the light strip will be on
 #define ERROR_LIGHT_ON HIGH ///< pin state at which the error light will be on
 
 #define HEATER_TEMP_SENSOR_ADDRESS 0x18 ///< I2C address of the heater temp sensor
@@ -136,6 +235,8 @@ constexpr uint8_t buildVersion = 18; // this might be useful if you make your ow
 
 #define SCREEN_HEIGHT 64 ///< OLED display height, in pixels | code currently not designed for this to be changed. sorry.
 #define SCREEN_WIDTH 128 ///< OLED display width, in pixels | code currently not designed for this to be changed. sorry.
+#define STATS_WINDOW 32 ///< the number of values the rolling min / avg / max stats are found from
+#define DISPLAY_STATS_INTERVAL 1000 ///< the time (in milliseconds) between display stats reports over USB
 #define LINE_GAP 2 // gap to be inserted between lines of text on screen, in pixels
 #define LINE_SPACING (CHARACTER_HEIGHT + LINE_GAP) /// the number of pixels between the top of each line of text
 #define VISIBLE_MENU_ITEMS ((SCREEN_HEIGHT - ((CHARACTER_HEIGHT * 2) - LINE_GAP)) / LINE_SPACING) // the number of menu items that are visible when the print name is not displayed
@@ -157,6 +258,8 @@ constexpr bool downSw_ps = LOW;
 #define UP_SWITCH_PIN 15 /// the pin connected to the "up" button | input
 #define DOWN_SWITCH_PIN 14 /// the pin connected to the "down" button | input
 
+#define LIGHT_STRIP_PIN 22 /// the pin connected to the light strip inside the enclosure | output | PWM slice 3, which nothing else uses
+
 #define SERVO_2_PIN 20 /// the pin connected to servo 1 | output
 #define SERVO_1_PIN 19 /// the pin connected to servo 2 | output
 
@@ -181,6 +284,12 @@ constexpr bool downSw_ps = LOW;
 #define LIGHTS_PIN 2 /// the pin connected to the enclosure lights | output
 #define PSU_ON_PIN 1 /// the pin connected to the PSUs power on pin | output
 #define FAN_PIN 0 /// the pin connected to the vent fan | output
+#define FAN_HAS_TACH false /// set to "true" only if the vent fan's tachometer (sense) wire is connected to FAN_TACH_PIN | without it the fan's speed isn't measured, so there is no stall detection, and the vent closes FAN_SPIN_DOWN_TIME after the fan is turned off
+#define FAN_TACH_PIN 27 /// the pin connected to the vent fan's tachometer (if FAN_HAS_TACH) | input | must be an odd (PWM channel B) pin, and nothing else can use its PWM slice (slice 5)
+
+#if FAN_HAS_TACH && ((FAN_TACH_PIN % 2) == 0)
+#error "FAN_TACH_PIN must be an odd (PWM channel B) pin"
+#endif
 
 #if DEBUG
 #warning "USB debuging is enabled; remember to have the host connected and active at boot"
@@ -43,8 +43,33 @@
 #define CHARACTER_HEIGHT 8 ///< the height of a size 1 character
 #define CHARACTER_WIDTH 6 ///< the width of a size 1 character
 
+#define LIGHT_ZONE_MAIN 0 ///< the enclosure lights
+#define LIGHT_ZONE_PRINT_DONE 1 ///< the print done light
+#define LIGHT_ZONE_STRIP 2 ///< the light strip inside the enclosure
+#define LIGHT_ZONE_COUNT 3 ///< the number of light zones
+
+#define VENT_CLOSED 0 ///< the flaps are closed (and the servos detached)
+#define VENT_OPENING 1 ///< the flaps are moving to open
+#define VENT_OPEN 2 ///< the flaps are open (and the servos detached)
+#define VENT_CLOSING 3 ///< the flaps are moving to closed
+
+#define FAN_CURVE_COUNT_BYTE 0xFF ///< sent in place of a point number to set how many fan curve points are used
+
+#define TEMP_FRACTION_BITS 3 ///< the number of fractional bits in the fine (fixed-point) temperatures, like inTempFine
+
 #define CONTROL_MODE_ERROR 0
 #define CONTROL_MODE_TEMP 1 ///< maintain target temperature
 #define CONTROL_MODE_MANUAL 2 ///< follow manual control
+#define CONTROL_MODE_PID 3 ///< maintain target temperature with the PID controller
+#define CONTROL_MODE_AUTOTUNE 4 ///< find the PID gains (then switch to CONTROL_MODE_PID)
+#define CONTROL_MODE_CASCADE 5 ///< maintain target temperature by setting a target heater temp, which a second (inner) PID controller holds
+
+#define PID_OUTPUT_MAX 1000 ///< the PID controller's output runs from -this (full cooling) to this (full heating)
+
+#define HEATER_DEMAND_MAX 1000 ///< a heater's demand runs from 0 (off) to this (always on), so it is the on fraction of each window in tenths of a percent
+
+#define PID_GAIN_KP 0 ///< sent to select the proportional gain when setting PID gains
+#define PID_GAIN_KI 1 ///< sent to select the integral gain when setting PID gains
+#define PID_GAIN_KD 2 ///< sent to select the derivative gain when setting PID gains
 
 #define SERIAL_SPEED 115200 ///< the buad rate that will be used for serial communication
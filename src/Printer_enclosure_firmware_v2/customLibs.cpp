@@ -22,6 +22,9 @@
 */
 
 #include "customLibs.hpp"
+#include <hardware/pwm.h>
+#include <hardware/irq.h>
+#include <hardware/clocks.h>
 
 //** - Timer - ********************************************************************************************************************************************************************
 
@@ -331,13 +334,105 @@ inline bool buffers::CircularBuffer::isEmpty() {
   return circularBuffer_writePos == circularBuffer_readPos; // return true if the read and write positions are the same (the buffer is empty)
 }
 
+//** - RollingStat - **************************************************************************************************************************************************************
+
+stats::RollingStat::RollingStat() : rollingStat_next(0), rollingStat_count(0) {}
+
+void stats::RollingStat::add(uint32_t value) {
+  rollingStat_values[rollingStat_next] = value;
+  rollingStat_next = (rollingStat_next + 1) % STATS_WINDOW;
+  if (rollingStat_count < STATS_WINDOW) rollingStat_count++;
+}
+
+uint32_t stats::RollingStat::getMin() const {
+  if (rollingStat_count == 0) return 0;
+
+  uint32_t minVal = UINT32_MAX;
+  for (uint8_t i = 0; i < rollingStat_count; i++) minVal = min(minVal, rollingStat_values[i]);
+
+  return minVal;
+}
+
+uint32_t stats::RollingStat::getAvg() const {
+  if (rollingStat_count == 0) return 0;
+
+  uint64_t sum = 0;
+  for (uint8_t i = 0; i < rollingStat_count; i++) sum += rollingStat_values[i];
+
+  return sum / rollingStat_count;
+}
+
+uint32_t stats::RollingStat::getMax() const {
+  uint32_t maxVal = 0;
+  for (uint8_t i = 0; i < rollingStat_count; i++) maxVal = max(maxVal, rollingStat_values[i]);
+
+  return maxVal;
+}
+
+//** - PWMOutput - ****************************************************************************************************************************************************************
+
+outputs::PWMOutput::PWMOutput(uint8_t pin, uint32_t frequency, uint8_t bits, bool onState)
+  : pwmOutput_pin(pin), pwmOutput_slice(pwm_gpio_to_slice_num(pin)), pwmOutput_frequency(frequency), pwmOutput_top((static_cast<uint32_t>(1) << min(bits, static_cast<uint8_t>(15))) - 1), pwmOutput_onState(onState) {}
+
+void outputs::PWMOutput::begin() {
+  float clkdiv = static_cast<float>(clock_get_hz(clk_sys)) / (static_cast<float>(pwmOutput_top + 1) * pwmOutput_frequency);
+  uint32_t invertBit = (pwm_gpio_to_channel(pwmOutput_pin) == PWM_CHAN_B) ? PWM_CH0_CSR_B_INV_BITS : PWM_CH0_CSR_A_INV_BITS;
+
+  pwm_set_clkdiv(pwmOutput_slice, max(clkdiv, 1.0f)); // a divider under 1 can't be set, so too high a frequency for the resolution ends up slower
+  pwm_set_wrap(pwmOutput_slice, pwmOutput_top);
+  hw_write_masked(&pwm_hw->slice[pwmOutput_slice].csr, pwmOutput_onState ? 0 : invertBit, invertBit); // only this channel's polarity, so the other pin on the slice keeps its own
+  pwm_set_gpio_level(pwmOutput_pin, 0); // off
+
+  gpio_set_function(pwmOutput_pin, GPIO_FUNC_PWM);
+  pwm_set_enabled(pwmOutput_slice, true);
+}
+
+void outputs::PWMOutput::write(uint16_t duty) {
+  pwm_set_gpio_level(pwmOutput_pin, toCompare(duty));
+}
+
+uint16_t outputs::PWMOutput::toCompare(uint16_t duty) {
+  if (duty == UINT16_MAX) return pwmOutput_top + 1; // one past the top, so the pin stays on for the whole period (scaling would only reach the top, which turns it off for one count)
+
+  return ((static_cast<uint32_t>(duty) * (pwmOutput_top + 1)) + 32768) >> 16; // rounded to the nearest step
+}
+
+uint8_t outputs::PWMOutput::getPin() {
+  return pwmOutput_pin;
+}
+
 //** - Light - ********************************************************************************************************************************************************************
 
-lights::Light::Light(uint8_t pin, uint8_t speed, bool onState, bool state, std::atomic<bool> *PSUVar)
-  : light_pin(pin), light_speed(speed), light_onState(onState), light_state(state), light_PSUVar(PSUVar) {
+lights::Light::Light(uint8_t pin, uint32_t pwmFrequency, uint8_t pwmBits, std::atomic<uint16_t> *fadeTimeVar, std::atomic<uint8_t> *levelVar, bool onState, bool state, std::atomic<bool> *PSUVar)
+  : light_pin(pin), light_output(pin, pwmFrequency, pwmBits, HIGH), light_fadeTimeVar(fadeTimeVar), light_levelVar(levelVar), light_onState(onState), light_state(state), light_level(levelVar->load()), light_waitingForPower(false), light_pattern(nullptr), light_patternStart(0), light_blipping(false), light_blipAlarm(0), light_PSUVar(PSUVar) {
   pinMode(light_pin, OUTPUT);
   digitalWrite(light_pin, light_state);
-  light_time = millis();
+  light_fade.setLevel(targetLevel());
+}
+
+void lights::Light::beginPWM() {
+  light_output.begin();
+  writeLevel(light_fade.getFineLevel());
+}
+
+uint8_t lights::Light::targetLevel() {
+  uint8_t onLevel = light_onState ? light_level : (255 - light_level); // the pin level when on
+
+  if (light_state == light_onState) return onLevel;
+
+  return light_onState ? 0 : 255;
+}
+
+uint16_t lights::Light::getCompareLevel() {
+  return light_output.toCompare(levelToDuty(light_fade.getFineLevel()));
+}
+
+void lights::Light::writeLevel(uint16_t fineLevel) {
+  writeDuty(levelToDuty(fineLevel));
+}
+
+void lights::Light::writeDuty(uint16_t duty) {
+  light_output.write(duty);
 }
 
 uint8_t lights::Light::getPin() {
@@ -345,20 +440,23 @@ uint8_t lights::Light::getPin() {
 }
 
 bool lights::Light::needsPower() {
-  if (light_onState) {
-    return (light_state || light_changing);
+  return ((getState() && light_level) || light_changing || light_pattern);
+}
 
-  } else {
-    return (!light_state || light_changing);
-  }
+void lights::Light::setFadeTime(uint16_t fadeTime) {
+  light_fadeTimeVar->store(fadeTime);
+}
+
+uint16_t lights::Light::getFadeTime() {
+  return light_fadeTimeVar->load();
 }
 
-void lights::Light::setSpeed(uint8_t speed) {
-  light_speed = speed;
+void lights::Light::setLevel(uint8_t level) {
+  light_levelVar->store(level); // tick() starts the fade
 }
 
-uint8_t lights::Light::getSpeed() {
-  return light_speed;
+uint8_t lights::Light::getLevel() {
+  return light_levelVar->load();
 }
 
 void lights::Light::setState(bool state) {
@@ -397,62 +495,251 @@ bool lights::Light::getState() {
   }
 }
 
-void lights::Light::tick() {
-  if (!light_changing) { // If we are not in the process of changing the light state
-    return; // return without doing anything
+void lights::Light::setPattern(const Pattern* pattern) {
+  if (pattern == light_pattern) return; // already playing it
+
+  light_patternStart = millis();
+  light_pattern = pattern;
+
+  if (pattern == nullptr) { // fade from wherever the pattern left off back to the light's state
+    light_toChange = true;
+    light_changing = true;
   }
+}
+
+const lights::Pattern* lights::Light::getPattern() {
+  return light_pattern;
+}
+
+void lights::Light::tick() {
+  uint8_t level = light_levelVar->load();
 
-  if (light_toChange) { // initialization for if we haven't started changing yet
-    light_toChange = false;
+  if (level != light_level) { // if the level has been changed
+    light_level = level;
 
-    if (light_state) { // if we are going to HIGH
-      light_i = 0; // Start from fully LOW
+    if (getState()) { // only fade if the light is on; otherwise the new level is used next time it turns on
+      light_toChange = true;
+      light_changing = true;
+    }
+  }
 
-    } else { // if we are going to LOW
-      light_i = 255; // Start from fully HIGH
+  if (!light_toChange) { // If there isn't a new state to start changing to
+    return; // return without doing anything
+  }
+
+  if (!light_PSUVar->load()) { // if the PSU isn't on yet (needsPower() is true while changing, so it will be turned on)
+    if (!light_waitingForPower) { // if we just started waiting
+      light_waitingForPower = true;
+      light_waitStart = millis();
     }
 
-    while (!light_PSUVar->load()); // wait for the PSU to be on
+    return; // try again next time
+  }
 
-    light_time = millis(); // reset the last updtate time so that the lights don't turn on all at once
+  if (light_waitingForPower) { // if we had to wait for the PSU
+    light_waitingForPower = false;
+    light_powerWaitStat.add(millis() - light_waitStart);
   }
 
-  uint32_t currentTime = millis();
-  uint32_t elapsedTime = currentTime - light_time;
+  light_toChange = false;
 
-  if (!(elapsedTime >= light_speed)) { // if it's not time to update the light brightness
-    return; // return without doing anything
+  light_fade.start(targetLevel(), (static_cast<uint32_t>(light_fadeTimeVar->load()) * LIGHT_FADE_TICK_HZ) / 1000);
+  light_changing = true; // in case the fade interrupt just finished the last fade
+} // lights::Light::tick()
+
+bool lights::Light::isWaitingForPower() {
+  return light_waitingForPower;
+}
+
+const stats::RollingStat& lights::Light::getPowerWaitStat() {
+  return light_powerWaitStat;
+}
+
+bool lights::Light::fadeStep() {
+  const Pattern* pattern = light_pattern;
+
+  if (pattern) {
+    if (!light_PSUVar->load()) return false; // wait for the PSU (needsPower() is true while a pattern plays, so it will be turned on)
+
+    uint16_t fineLevel = (static_cast<uint32_t>(patternLevel(*pattern, millis() - light_patternStart)) * light_level) / 255;
+
+    if (!light_onState) fineLevel = (255 << 8) - fineLevel; // as a pin level
+
+    bool changed = (fineLevel != light_fade.getFineLevel()) && !light_blipping;
+    light_fade.setFineLevel(fineLevel);
+
+    return changed;
   }
 
-  light_time = currentTime; // Update the last update time
+  if (!light_changing) return false;
 
-  if (light_state) { // Turning the light HIGH
-    // Calculate the increment to apply this tick
-    uint8_t increment = min(uint8_t(elapsedTime / light_speed), uint8_t(255 - light_i));
-    light_i += increment;
-    analogWrite(light_pin, light_i);
+  bool changed = light_fade.step() && !light_blipping; // the level is written when the blip ends if the light is blipping
 
-    if (light_i >= 255) { // If we've reached fully HIGH
-      light_i = 255; // Clamp to max value
-      light_changing = false; // Stop changing the light
-    }
+  if (light_fade.isDone() && !light_toChange) { // if the fade is done (and another one isn't about to start)
+    light_changing = false;
+  }
 
-  } else { // Turning the light to LOW
-    // Calculate the decrement to apply this tick
-    uint8_t decrement = min(uint8_t(elapsedTime / light_speed), light_i);
-    light_i -= decrement;
-    analogWrite(light_pin, light_i);
-
-    if (light_i <= 0) { // If we've reached fully LOW
-      light_i = 0; // Clamp to min value
-      light_changing = false; // Stop changing the light
-      
-    } // if (light_i <= 0)
-  } // else (  if (light_state)  )
-} // lights::Light::tick()
+  return changed;
+}
 
 void lights::Light::blip(uint32_t microseconds) {
-  analogWrite(light_pin, (light_state * 255) ^ 4); // set the lights to 4/255 of set to LOW, 251/255 if set to HIGH
-  delayMicroseconds(microseconds);
-  analogWrite(light_pin, (light_state * 255));
+  if (light_blipping) cancel_alarm(light_blipAlarm); // if already blipping, start the time over
+
+  uint32_t interrupts = LightManager::lockLevels(); // so the fade interrupt can't write a level it worked out before the blip started over the blip level
+  light_blipping = true;
+  writeDuty(((light_state * 255) ^ 4) * 257); // set the lights to 4/255 of set to LOW, 251/255 if set to HIGH (not gamma corrected, so the blip is the same as it always was)
+  LightManager::unlockLevels(interrupts);
+
+  light_blipAlarm = add_alarm_in_us(microseconds, endBlip, this, true);
+
+  if (light_blipAlarm <= 0) { // if the alarm couldn't be set (or the time had already passed), end the blip now
+    endBlip(0, this);
+  }
+}
+
+int64_t lights::Light::endBlip(alarm_id_t id, void* light) {
+  Light* self = static_cast<Light*>(light);
+
+  uint32_t interrupts = LightManager::lockLevels(); // so the fade can't step between reading the level and writing it
+  self->light_blipping = false;
+  self->writeLevel(self->light_fade.getFineLevel()); // go back to where the light is now (it may have kept fading)
+  LightManager::unlockLevels(interrupts);
+
+  return 0; // don't repeat
+}
+
+//** - LightManager - *************************************************************************************************************************************************************
+
+lights::LightManager* lights::LightManager::lightManager_instance = nullptr;
+spin_lock_t* const lights::LightManager::lightManager_lock = spin_lock_instance(next_striped_spin_lock_num()); // a shared (striped) lock is fine, it is only held for a few register writes and never nested
+
+lights::LightManager::LightManager(Light *zones, uint8_t zoneCount) : lightManager_zones(zones), lightManager_zoneCount(zoneCount) {}
+
+void lights::LightManager::begin() {
+  for (uint8_t i = 0; i < lightManager_zoneCount; i++) {
+    lightManager_zones[i].beginPWM();
+  }
+
+  lightManager_instance = this;
+
+  // the fade slice doesn't drive any pins (its pins are normal inputs), it is only used to time the fades
+  pwm_config config = pwm_get_default_config();
+  pwm_config_set_clkdiv(&config, clock_get_hz(clk_sys) / 1000000.0f); // count at 1 MHz
+  pwm_config_set_wrap(&config, (1000000 / LIGHT_FADE_TICK_HZ) - 1); // wrap LIGHT_FADE_TICK_HZ times a second
+  pwm_init(LIGHT_FADE_SLICE, &config, false);
+
+  pwm_clear_irq(LIGHT_FADE_SLICE);
+  pwm_set_irq_enabled(LIGHT_FADE_SLICE, true);
+  irq_add_shared_handler(PWM_IRQ_WRAP, fadeTick, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(PWM_IRQ_WRAP, true);
+
+  pwm_set_enabled(LIGHT_FADE_SLICE, true);
+}
+
+void lights::LightManager::tick() {
+  for (uint8_t i = 0; i < lightManager_zoneCount; i++) {
+    lightManager_zones[i].tick();
+  }
+}
+
+bool lights::LightManager::needsPower() {
+  for (uint8_t i = 0; i < lightManager_zoneCount; i++) {
+    if (lightManager_zones[i].needsPower()) return true;
+  }
+
+  return false;
+}
+
+uint8_t lights::LightManager::getZoneCount() {
+  return lightManager_zoneCount;
+}
+
+lights::Light* lights::LightManager::getZone(uint8_t zone) {
+  if (zone >= lightManager_zoneCount) return nullptr;
+
+  return &lightManager_zones[zone];
+}
+
+void lights::LightManager::fadeStep() {
+  uint32_t levels[NUM_PWM_SLICES] = {}; // the new compare values, packed the same way as each slice's CC register (channel A in the low half, B in the high half)
+  uint32_t masks[NUM_PWM_SLICES] = {}; // which halves of each CC register have a new value
+  uint8_t changedSlices = 0; // one bit per slice
+
+  uint32_t interrupts = lockLevels(); // a blip (from the other core) waits until the new levels are written, so it is never overwritten by one worked out before it
+
+  for (uint8_t i = 0; i < lightManager_zoneCount; i++) { // work out every new level before touching the hardware
+    Light& zone = lightManager_zones[i];
+
+    if (!zone.fadeStep()) continue;
+
+    uint8_t slice = pwm_gpio_to_slice_num(zone.getPin());
+    uint8_t shift = (pwm_gpio_to_channel(zone.getPin()) == PWM_CHAN_B) ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB;
+
+    levels[slice] |= static_cast<uint32_t>(zone.getCompareLevel()) << shift;
+    masks[slice] |= static_cast<uint32_t>(0xFFFF) << shift;
+    changedSlices |= 1 << slice;
+  }
+
+  for (uint8_t slice = 0; changedSlices; slice++, changedSlices >>= 1) { // one write per slice | the slices latch the new values at their next wrap, so every zone changes in the same PWM period
+    if (changedSlices & 1) hw_write_masked(&pwm_hw->slice[slice].cc, levels[slice], masks[slice]);
+  }
+
+  unlockLevels(interrupts);
+}
+
+uint32_t lights::LightManager::lockLevels() {
+  return spin_lock_blocking(lightManager_lock);
+}
+
+void lights::LightManager::unlockLevels(uint32_t interrupts) {
+  spin_unlock(lightManager_lock, interrupts);
+}
+
+void lights::LightManager::fadeTick() {
+  if (!(pwm_get_irq_status_mask() & (1 << LIGHT_FADE_SLICE))) return; // the interrupt was from another slice
+
+  pwm_clear_irq(LIGHT_FADE_SLICE);
+
+  if (lightManager_instance) lightManager_instance->fadeStep();
+}
+
+//** - Tachometer - ***************************************************************************************************************************************************************
+
+fans::Tachometer::Tachometer(uint8_t pin, uint8_t pulsesPerRev, uint16_t interval)
+  : tachometer_pin(pin), tachometer_slice(pwm_gpio_to_slice_num(pin)), tachometer_pulsesPerRev(pulsesPerRev), tachometer_interval(static_cast<uint32_t>(interval) * 1000),
+  tachometer_lastCount(0), tachometer_lastTime(0), tachometer_rpm(0) {}
+
+void fans::Tachometer::begin() {
+  pwm_config config = pwm_get_default_config();
+  pwm_config_set_clkdiv_mode(&config, PWM_DIV_B_FALLING); // count falling edges on the B pin instead of clock cycles
+  pwm_config_set_clkdiv(&config, 1);
+  pwm_init(tachometer_slice, &config, false);
+
+  gpio_set_function(tachometer_pin, GPIO_FUNC_PWM);
+  gpio_pull_up(tachometer_pin); // fan tachometers are open collector
+
+  pwm_set_enabled(tachometer_slice, true);
+
+  tachometer_lastCount = pwm_get_counter(tachometer_slice);
+  tachometer_lastTime = micros();
+}
+
+bool fans::Tachometer::update() {
+  uint32_t now = micros();
+  uint32_t elapsed = now - tachometer_lastTime;
+
+  if (elapsed < tachometer_interval) return false;
+
+  uint16_t count = pwm_get_counter(tachometer_slice);
+  uint16_t pulses = count - tachometer_lastCount; // the counter wraps at 16 bits, and so does this
+
+  tachometer_rpm = pulsesToRPM(pulses, elapsed, tachometer_pulsesPerRev);
+  tachometer_lastCount = count;
+  tachometer_lastTime = now;
+
+  return true;
+}
+
+uint16_t fans::Tachometer::getRPM() {
+  return tachometer_rpm;
 }
@@ -23,8 +23,11 @@
 #pragma once
 
 #include "config.hpp"
+#include "logicLibs.hpp"
 #include <Arduino.h>
 #include <pico/mutex.h>
+#include <hardware/sync.h>
+#include <pico/time.h>
 #include <atomic>
 #include <type_traits>
 
@@ -183,6 +186,43 @@ namespace buffers {
   };
 }
 
+namespace stats {
+  /**
+  * @brief keeps the last STATS_WINDOW values of something (like a time) to find their minimum, average, and maximum | not multicore-safe
+  */
+  class RollingStat {
+    public:
+      RollingStat();
+
+      /**
+      * @brief adds a value, replacing the oldest one if the window is full
+      */
+      void add(uint32_t value);
+
+      /**
+      * @brief returns the smallest value in the window (0 if it is empty)
+      */
+      uint32_t getMin() const;
+
+      /**
+      * @brief returns the average of the values in the window (0 if it is empty)
+      */
+      uint32_t getAvg() const;
+
+      /**
+      * @brief returns the largest value in the window (0 if it is empty)
+      */
+      uint32_t getMax() const;
+
+    private:
+      uint32_t rollingStat_values[STATS_WINDOW]; ///< the values in the window
+
+      uint8_t rollingStat_next; ///< where the next value will go
+
+      uint8_t rollingStat_count; ///< how many values are in the window
+  };
+}
+
 namespace menu {
   // Generic template defaults to false
   template<typename T>
@@ -204,6 +244,7 @@ namespace menu {
       virtual ~baseMenuItem() = default;
 
       virtual String getName() const = 0;
+      virtual const char* getNameChars() const = 0;
 
       virtual String getSubData(uint8_t index) const = 0; // depricated
 
@@ -214,10 +255,12 @@ namespace menu {
       virtual void setData(uint32_t data) = 0;
       virtual uint32_t getData() const = 0;
       virtual String getDataString() const = 0;
+      virtual const char* getDataSubChars() const = 0;
 
       virtual void setTempData(uint32_t data) = 0;
       virtual uint32_t getTempData() const = 0;
       virtual String getTempDataString() const = 0;
+      virtual const char* getTempDataSubChars() const = 0;
       virtual void incrementTempData() = 0;
       virtual void decrementTempData() = 0;
 
@@ -326,6 +369,13 @@ namespace menu {
         return menuItem_name;
       }
 
+      /**
+      * @brief returns the name of the menu item without copying it (nothing is allocated)
+      */
+      const char* getNameChars() const override {
+        return menuItem_name.c_str();
+      }
+
       /**
       * @brief returns the substituted String for the value of the data
       */
@@ -396,6 +446,13 @@ namespace menu {
         return String(data);
       }
 
+      /**
+      * @brief returns the String substituted for the value of the data without copying it, or nullptr if there isn't one (nothing is allocated)
+      */
+      const char* getDataSubChars() const override {
+        return findSubChars(getData());
+      }
+
       /**
       * @brief use to edit temporary data (not the actual variable pointed to as the data)
       * @note value is returned and stored as a uint32_t, you will have to cast it if negative
@@ -427,6 +484,13 @@ namespace menu {
         return String(menuItem_tempVal);
       }
 
+      /**
+      * @brief returns the String substituted for the value of the temporary data without copying it, or nullptr if there isn't one (nothing is allocated)
+      */
+      const char* getTempDataSubChars() const override {
+        return findSubChars(menuItem_tempVal);
+      }
+
       /**
       * @brief adds one to the temporary data, clamping it within the min and max values
       */
@@ -513,6 +577,63 @@ namespace menu {
       const uint8_t menuItem_indexOffset; ///< the amount the vector index will be offset relative to the provided one
       
       const bool menuItem_subsUsed; ///< tracks if number-character substitution is used
+
+      /**
+      * @brief returns the substitution for a value, or nullptr if there isn't one
+      */
+      const char* findSubChars(uint32_t value) const {
+        if (!menuItem_subsUsed) return nullptr;
+
+        uint8_t offsetIndex = (value - menuItem_indexOffset);
+
+        if (offsetIndex >= static_cast<uint8_t>(menuItem_valueSubs.size())) return nullptr; // if the index is outside of the vector
+
+        return menuItem_valueSubs[offsetIndex].c_str();
+      }
+  };
+}
+
+namespace outputs {
+  /**
+  * @brief a pin driven by its PWM slice at a set frequency and resolution, with its on state (polarity) set in hardware
+  * @note the two pins on a slice (an even pin and the odd one after it) share its frequency and resolution, so give their outputs the same ones
+  */
+  class PWMOutput {
+    public:
+      /**
+      * @param pin the pin to drive
+      * @param frequency the PWM frequency (in Hz)
+      * @param bits the resolution, in bits (up to 15)
+      * @param onState the HIGH / LOW state the pin is at when on | the channel is inverted in hardware if this is LOW, so a duty is always how much of the time it's on
+      */
+      PWMOutput(uint8_t pin, uint32_t frequency, uint8_t bits, bool onState);
+
+      /**
+      * @brief sets the slice's frequency and resolution and the channel's polarity, and starts the pin outputting PWM (off) | only touches this pin's channel, besides the shared frequency and resolution
+      */
+      void begin();
+
+      /**
+      * @brief sets the duty cycle (0 - 65535), scaled to the slice's range
+      */
+      void write(uint16_t duty);
+
+      /**
+      * @brief scales a duty cycle (0 - 65535) to the slice's range (the value for the pin's PWM compare register) | 65535 gives one past the top, so the pin is fully on
+      */
+      uint16_t toCompare(uint16_t duty);
+
+      /**
+      * @brief returns the pin number
+      */
+      uint8_t getPin();
+
+    private:
+      const uint8_t pwmOutput_pin; ///< the pin being driven
+      const uint8_t pwmOutput_slice; ///< the pin's PWM slice
+      const uint32_t pwmOutput_frequency; ///< the PWM frequency (Hz)
+      const uint16_t pwmOutput_top; ///< the slice's wrap value (one less than its range)
+      const bool pwmOutput_onState; ///< the HIGH / LOW state the pin is at when on
   };
 }
 
@@ -523,13 +644,16 @@ namespace lights {
   class Light {
     public:
       /**
-      * @brief initializes the light with it's inital state and the speed at which to change it
+      * @brief initializes the light with it's inital state and the time it takes to change it
       * @param pin the pin the light is connected to
-      * @param speed the speed the light will change at (lower is faster)
+      * @param pwmFrequency the PWM frequency (in Hz) of the light's pin
+      * @param pwmBits the PWM resolution of the light's pin, in bits (up to 15)
+      * @param fadeTimeVar a pointer to a variable containing the time (in milliseconds) a full fade on or off will take
+      * @param levelVar a pointer to a variable containing the brightness (0 - 255) of the light when it is on
       * @param state the initial state of the light
       * @param PSUVar a pointer to a variable containing the state of the PSU
       */
-      Light(uint8_t pin, uint8_t speed, bool onState, bool state, std::atomic<bool> *PSUVar);
+      Light(uint8_t pin, uint32_t pwmFrequency, uint8_t pwmBits, std::atomic<uint16_t> *fadeTimeVar, std::atomic<uint8_t> *levelVar, bool onState, bool state, std::atomic<bool> *PSUVar);
 
       /**
       * @brief returns the pin number ascosiated with the light
@@ -537,19 +661,29 @@ namespace lights {
       uint8_t getPin();
 
       /**
-      * @brief returns true if the light is changing OR on, false otherwise (if it is off AND not changing)
+      * @brief returns true if the light is changing OR on (at a level above 0), false otherwise (if it is off AND not changing)
       */
       bool needsPower();
 
       /**
-      * @brief sets the speed to change the light at (lower is faster)
+      * @brief sets the time (in milliseconds) a full fade on or off will take | takes effect the next time the light starts fading
+      */
+      void setFadeTime(uint16_t fadeTime);
+
+      /**
+      * @brief returns the time (in milliseconds) a full fade on or off will take
+      */
+      uint16_t getFadeTime();
+
+      /**
+      * @brief sets the brightness (0 - 255) of the light when it is on | if the light is on it fades to the new level
       */
-      void setSpeed(uint8_t speed);
+      void setLevel(uint8_t level);
 
       /**
-      * @brief returns the diming speed of the light, in ms per 1/255 full brightness
+      * @brief returns the brightness (0 - 255) of the light when it is on
       */
-      uint8_t getSpeed();
+      uint8_t getLevel();
 
       /**
       * @brief sets the state of the light
@@ -567,25 +701,198 @@ namespace lights {
       bool getState();
 
       /**
-      * @brief call as often as possible, handles all actual setting of the light (diming, etc.)
+      * @brief starts playing a pattern (it loops until stopped), or stops the current one if pattern is nullptr | the light's state and fades are ignored while a pattern plays, and it fades back to its state once stopped
+      * @note does nothing if the pattern is already playing, so it can be called every loop
+      */
+      void setPattern(const Pattern* pattern);
+
+      /**
+      * @brief returns the pattern being played, or nullptr if there isn't one
+      */
+      const Pattern* getPattern();
+
+      /**
+      * @brief call as often as possible, starts fades when the state or level has changed (the fades themselves are run from the fade interrupt) | never blocks; if the PSU is off the fade starts once it is on
       */
       void tick();
 
+      /**
+      * @brief returns true if the light is waiting for the PSU to turn on before it starts fading
+      */
+      bool isWaitingForPower();
+
+      /**
+      * @brief returns the stats for how long (in milliseconds) the light has had to wait for the PSU to turn on
+      */
+      const stats::RollingStat& getPowerWaitStat();
+
+      /**
+      * @brief advances the fade (or pattern) by one tick | called from the fade interrupt (by LightManager::fadeStep())
+      * @return true if the pin needs the new level (from getCompareLevel()) written to it
+      */
+      bool fadeStep();
+
+      /**
+      * @brief returns the current level, gamma corrected and scaled to the slice's range (the value for the pin's PWM compare register)
+      */
+      uint16_t getCompareLevel();
+
+      /**
+      * @brief sets the pin up for PWM at the light's current level | called by LightManager::begin()
+      */
+      void beginPWM();
+
       /**
       * @brief breifly changes the state of the light, then revets to what it was again. Used to fix a hardware issue | EXPERIMENTAL
+      * @note returns right away; an alarm puts the light back after <microseconds>. Blipping again before then just restarts the alarm
       * @param microseconds the amount of time that the light's state will be inverted for
       */
       void blip(uint32_t microseconds);
     
     private:
       const uint8_t light_pin; ///< the pin number the light is attached to
-      volatile uint8_t light_speed; ///< the speed at which the light will dim / brighten
+      outputs::PWMOutput light_output; ///< the light's pin | not inverted in hardware, as the light's levels are already pin levels
+      std::atomic<uint16_t> *light_fadeTimeVar; ///< a pointer to a (external) variable that contains the time (ms) a full fade on or off takes
+      std::atomic<uint8_t> *light_levelVar; ///< a pointer to a (external) variable that contains the brightness of the light when it is on
       const bool light_onState; ///< the HIGH / LOW state that the light pin is at when ON
       volatile bool light_state; ///< the target state of the light
+      volatile uint8_t light_level; ///< the brightness the light is on at (the last level read from light_levelVar)
       volatile bool light_changing; ///< true if the light is changing to a new state
       volatile bool light_toChange; ///< true if the light is set to begin changing to a new state, but has not yet began
-      volatile uint8_t light_i; ///< the current PWM value of the light pin. | Used to incrament / decrement brightness
-      volatile uint32_t light_time; ///< the current time from startup in milliseconds
+      FadeStepper light_fade; ///< the current PWM value of the light pin, and the fade towards its target
+      volatile bool light_waitingForPower; ///< true if a fade is waiting for the PSU to turn on
+      const Pattern* volatile light_pattern; ///< the pattern being played (nullptr if none)
+      volatile uint32_t light_patternStart; ///< when the pattern started (ms)
+      volatile bool light_blipping; ///< true while a blip is holding the light at its blip level (fades keep going, but aren't written to the pin)
+      volatile alarm_id_t light_blipAlarm; ///< the alarm that will end the blip
+      uint32_t light_waitStart; ///< when the light started waiting for the PSU (ms)
+      stats::RollingStat light_powerWaitStat; ///< how long the light has had to wait for the PSU (ms)
       std::atomic<bool> *light_PSUVar; ///< a pointer to a (external) variable that contains the state of the PSU
+
+      /**
+      * @brief returns the level (as a pin level, so inverted if the light is on when LOW) the light should fade to
+      */
+      uint8_t targetLevel();
+
+      /**
+      * @brief writes a level to the pin, gamma corrected and scaled to the slice's range
+      */
+      void writeLevel(uint16_t fineLevel);
+
+      /**
+      * @brief writes a 16-bit duty cycle to the pin, scaled to the slice's range
+      */
+      void writeDuty(uint16_t duty);
+
+      /**
+      * @brief ends a blip, putting the light back to its current level | alarm callback
+      */
+      static int64_t endBlip(alarm_id_t id, void* light);
+  };
+
+  /**
+  * @brief owns an array of lights (zones), ticks them all in one pass, and steps their fades from the PWM wrap interrupt, writing all of their PWM registers together
+  */
+  class LightManager {
+    public:
+      /**
+      * @param zones the array of lights to manage
+      * @param zoneCount the number of lights in the array
+      */
+      LightManager(Light *zones, uint8_t zoneCount);
+
+      /**
+      * @brief sets up every zone's pin for PWM, and starts the PWM wrap interrupt that steps the fades (LIGHT_FADE_TICK_HZ times a second) | call from the core that should handle the interrupt
+      */
+      void begin();
+
+      /**
+      * @brief ticks every zone | call as often as possible
+      */
+      void tick();
+
+      /**
+      * @brief returns true if any zone needs power
+      */
+      bool needsPower();
+
+      /**
+      * @brief returns the number of zones
+      */
+      uint8_t getZoneCount();
+
+      /**
+      * @brief returns a pointer to a zone, or nullptr if there is no such zone
+      */
+      Light* getZone(uint8_t zone);
+
+      /**
+      * @brief steps every zone's fade, then writes the new levels with one register write per PWM slice | called from the fade interrupt
+      */
+      void fadeStep();
+
+      /**
+      * @brief keeps the fade interrupt (on either core) from working out or writing levels until unlockLevels() is called, so a level written from elsewhere can't be overwritten by one worked out before it | interrupts are off on this core while it is held, so keep it short
+      * @return the interrupt state to give unlockLevels()
+      */
+      static uint32_t lockLevels();
+
+      /**
+      * @brief lets the fade interrupt write levels again
+      * @param interrupts the state returned by lockLevels()
+      */
+      static void unlockLevels(uint32_t interrupts);
+
+    private:
+      Light* const lightManager_zones; ///< the lights being managed
+      const uint8_t lightManager_zoneCount; ///< the number of lights being managed
+      static LightManager* lightManager_instance; ///< the manager the fade interrupt steps (the last one begun)
+      static spin_lock_t* const lightManager_lock; ///< held while levels are worked out and written (by the fade interrupt, or a blip)
+
+      /**
+      * @brief the PWM wrap interrupt handler
+      */
+      static void fadeTick();
+  };
+}
+
+namespace fans {
+  /**
+  * @brief measures a fan's speed by counting its tachometer pulses with a PWM slice (in counter mode, so no interrupts are used)
+  * @note the tachometer pin must be a PWM channel B pin (an odd GPIO), and nothing else can use its slice
+  */
+  class Tachometer {
+    public:
+      /**
+      * @param pin the pin the fan's tachometer output is connected to
+      * @param pulsesPerRev how many pulses the fan gives each revolution
+      * @param interval the time (in milliseconds) pulses are counted over for each reading
+      */
+      Tachometer(uint8_t pin, uint8_t pulsesPerRev, uint16_t interval);
+
+      /**
+      * @brief sets up the pin and starts counting pulses
+      */
+      void begin();
+
+      /**
+      * @brief takes a new reading if it has been at least <interval> ms since the last one | call as often as possible
+      * @return true if there is a new reading
+      */
+      bool update();
+
+      /**
+      * @brief returns the latest reading, in RPM
+      */
+      uint16_t getRPM();
+
+    private:
+      const uint8_t tachometer_pin; ///< the pin the tachometer is connected to
+      const uint8_t tachometer_slice; ///< the PWM slice counting the pulses
+      const uint8_t tachometer_pulsesPerRev; ///< how many pulses the fan gives each revolution
+      const uint32_t tachometer_interval; ///< the time (us) pulses are counted over for each reading
+      uint16_t tachometer_lastCount; ///< the slice's counter at the last reading
+      uint32_t tachometer_lastTime; ///< when the last reading was taken (us)
+      volatile uint16_t tachometer_rpm; ///< the latest reading
   };
 }
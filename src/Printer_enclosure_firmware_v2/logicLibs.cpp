@@ -0,0 +1,506 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "logicLibs.hpp"
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+//** - Light - ********************************************************************************************************************************************************************
+
+namespace {
+  /// builds the CIE 1931 lightness table: the 16-bit duty cycle for each perceptual level (0 - 255)
+  constexpr std::array<uint16_t, 256> makeLightnessTable() {
+    std::array<uint16_t, 256> table {};
+
+    for (uint16_t i = 0; i < 256; i++) {
+      float lightness = (i * 100.0f) / 255.0f; // L*, 0 - 100
+      float luminance = lightness / 903.3f; // Y, 0 - 1 (the linear part, near black)
+
+      if (lightness > 8.0f) {
+        float cubeRoot = (lightness + 16.0f) / 116.0f;
+        luminance = cubeRoot * cubeRoot * cubeRoot;
+      }
+
+      table[i] = static_cast<uint16_t>((luminance * 65535.0f) + 0.5f);
+    }
+
+    return table;
+  }
+
+  constexpr std::array<uint16_t, 256> lightnessTable = makeLightnessTable();
+}
+
+uint16_t lights::levelToDuty(uint16_t fineLevel) {
+  uint8_t index = fineLevel >> 8;
+  uint8_t fraction = fineLevel & 0xFF;
+
+  if (index == 255) return lightnessTable[255];
+
+  uint32_t low = lightnessTable[index];
+  uint32_t high = lightnessTable[index + 1];
+
+  return low + (((high - low) * fraction) >> 8); // interpolate between the two nearest entries
+}
+
+uint16_t lights::patternLevel(const Pattern& pattern, uint32_t elapsed) {
+  const Keyframe* keyframes = pattern.keyframes;
+  uint8_t count = pattern.keyframeCount;
+
+  if (count == 0) return 0;
+
+  uint16_t length = keyframes[count - 1].time;
+
+  if (count == 1 || length == 0) return keyframes[0].level << 8; // nothing to interpolate between
+
+  uint16_t time = elapsed % length;
+  uint8_t next = 1; // the first keyframe after <time>
+
+  while ((next < count - 1) && (keyframes[next].time <= time)) next++;
+
+  const Keyframe& from = keyframes[next - 1];
+  const Keyframe& to = keyframes[next];
+
+  if (to.time <= from.time) return to.level << 8; // a step
+
+  int32_t change = (static_cast<int32_t>(to.level) - from.level) << 8;
+
+  return (from.level << 8) + ((change * static_cast<int32_t>(time - from.time)) / (to.time - from.time));
+}
+
+//** - Trajectory - ***************************************************************************************************************************************************************
+
+void servos::Trajectory::setPosition(uint8_t position) {
+  trajectory_from = position;
+  trajectory_target = position;
+  trajectory_duration = 0;
+}
+
+void servos::Trajectory::start(uint8_t target, uint32_t now, uint16_t msPerDegree, uint16_t acceleration) {
+  uint8_t from = getPosition(now);
+  float distance = std::abs(static_cast<int16_t>(target) - from);
+
+  trajectory_from = from;
+  trajectory_target = target;
+  trajectory_direction = (target < from) ? -1 : 1;
+  trajectory_startTime = now;
+
+  if (msPerDegree == 0 || distance == 0) { // jump straight there
+    trajectory_duration = 0;
+    return;
+  }
+
+  float maxSpeed = 1.0f / msPerDegree;
+
+  if (acceleration == 0) { // no speeding up or slowing down
+    trajectory_acceleration = 0;
+    trajectory_peakSpeed = maxSpeed;
+    trajectory_accelTime = 0;
+    trajectory_accelDistance = 0;
+    trajectory_duration = distance / maxSpeed;
+    return;
+  }
+
+  trajectory_acceleration = acceleration / 1000000.0f; // deg. / s / s to deg. / ms / ms
+  trajectory_accelTime = maxSpeed / trajectory_acceleration;
+  trajectory_accelDistance = 0.5f * trajectory_acceleration * trajectory_accelTime * trajectory_accelTime;
+  trajectory_peakSpeed = maxSpeed;
+
+  if ((trajectory_accelDistance * 2) > distance) { // too short to reach full speed; speed up half way, then slow down
+    trajectory_accelTime = std::sqrt(distance / trajectory_acceleration);
+    trajectory_accelDistance = distance / 2;
+    trajectory_peakSpeed = trajectory_acceleration * trajectory_accelTime;
+  }
+
+  trajectory_duration = (2 * trajectory_accelTime) + ((distance - (2 * trajectory_accelDistance)) / trajectory_peakSpeed);
+}
+
+uint8_t servos::Trajectory::getPosition(uint32_t now) const {
+  float elapsed = now - trajectory_startTime;
+
+  if (elapsed >= trajectory_duration) return trajectory_target;
+
+  float distance; // how far the servo has moved
+
+  if (elapsed < trajectory_accelTime) { // speeding up
+    distance = 0.5f * trajectory_acceleration * elapsed * elapsed;
+
+  } else if (elapsed < (trajectory_duration - trajectory_accelTime)) { // cruising
+    distance = trajectory_accelDistance + (trajectory_peakSpeed * (elapsed - trajectory_accelTime));
+
+  } else { // slowing down
+    float remaining = trajectory_duration - elapsed;
+    distance = std::abs(static_cast<int16_t>(trajectory_target) - trajectory_from) - (0.5f * trajectory_acceleration * remaining * remaining);
+  }
+
+  return trajectory_from + (trajectory_direction * static_cast<int16_t>(distance + 0.5f));
+}
+
+uint8_t servos::Trajectory::getTarget() const {
+  return trajectory_target;
+}
+
+bool servos::Trajectory::isDone(uint32_t now) const {
+  return (now - trajectory_startTime) >= trajectory_duration;
+}
+
+//** - pulsesToRPM - ***************************************************************************************************************************************************************
+
+uint16_t fans::pulsesToRPM(uint32_t pulses, uint32_t interval, uint8_t pulsesPerRev) {
+  if (interval == 0 || pulsesPerRev == 0) return 0;
+
+  uint64_t rpm = (static_cast<uint64_t>(pulses) * 60000000) / (static_cast<uint64_t>(interval) * pulsesPerRev);
+
+  return std::min(rpm, static_cast<uint64_t>(UINT16_MAX));
+}
+
+//** - evaluateCurve - ************************************************************************************************************************************************************
+
+uint8_t fans::evaluateCurve(const CurvePoint* points, uint8_t count, int32_t error, uint8_t fractionBits) {
+  if (count == 0) return 0;
+
+  if (error <= (static_cast<int32_t>(points[0].error) << fractionBits)) return points[0].airflow; // below the curve
+
+  for (uint8_t i = 1; i < count; i++) {
+    int32_t start = static_cast<int32_t>(points[i - 1].error) << fractionBits;
+    int32_t end = static_cast<int32_t>(points[i].error) << fractionBits;
+
+    if (error >= end) continue; // past this segment
+
+    if (end <= start) return points[i].airflow; // a step (or the points are out of order)
+
+    int32_t from = points[i - 1].airflow;
+    int32_t to = points[i].airflow;
+
+    return std::clamp(from + (((to - from) * (error - start)) / (end - start)), static_cast<int32_t>(0), static_cast<int32_t>(255));
+  }
+
+  return points[count - 1].airflow; // above the curve
+}
+
+//** - runningSpeed - **************************************************************************************************************************************************************
+
+uint16_t fans::runningSpeed(uint16_t target, uint16_t cap, uint16_t floor) {
+  if (target == 0 || cap < floor) return 0;
+
+  return std::clamp(target, floor, cap);
+}
+
+//** - lowestAirflow - *************************************************************************************************************************************************************
+
+uint8_t fans::lowestAirflow(uint16_t minRPM, uint16_t maxRPM) {
+  if (maxRPM == 0) return 255;
+
+  uint32_t airflow = ((static_cast<uint32_t>(minRPM) * 255) + maxRPM - 1) / maxRPM; // rounded up, so it isn't just under
+  return std::min(airflow, static_cast<uint32_t>(255));
+}
+
+//** - planSpeed - *****************************************************************************************************************************************************************
+
+fans::SpeedPlan fans::planSpeed(uint8_t target, uint8_t cap, bool airflow, bool measured, uint16_t maxRPM, uint16_t minRPM, uint8_t minDuty) {
+  if (airflow && measured) return {true, runningSpeed((static_cast<uint32_t>(target) * maxRPM) / 255, (static_cast<uint32_t>(cap) * maxRPM) / 255, minRPM)};
+
+  return {false, runningSpeed(target, cap, minDuty)}; // without readings, a closed loop would only see 0 RPM and wind up to full duty
+}
+
+//** - RPMController - ************************************************************************************************************************************************************
+
+uint16_t fans::RPMController::update(uint16_t target, uint16_t measured, uint16_t maxRPM, uint8_t minDuty) {
+  if (target == 0 || maxRPM == 0) return 0;
+
+  constexpr int32_t fullDuty = 255 << 8; // with 8 fractional bits, like the rest of these
+  int32_t lowestDuty = static_cast<int32_t>(minDuty) << 8;
+
+  int32_t feedForward = (static_cast<int32_t>(std::min(target, maxRPM)) * fullDuty) / maxRPM; // the duty the target would need if speed were proportional to duty
+  int32_t error = static_cast<int32_t>(target) - measured;
+  int32_t proportional = error * rpmController_kp;
+  int32_t integral = std::clamp(rpmController_integral + (error * rpmController_ki), -fullDuty, fullDuty);
+
+  // only let the integral grow as far as it takes the output to reach a limit, so it doesn't wind up (but the output can still get all the way there)
+  if (error > 0) integral = std::min(integral, std::max(rpmController_integral, fullDuty - feedForward - proportional));
+  else if (error < 0) integral = std::max(integral, std::min(rpmController_integral, lowestDuty - feedForward - proportional));
+
+  rpmController_integral = integral;
+
+  int32_t output = feedForward + proportional + integral;
+
+  return (std::clamp(output, lowestDuty, fullDuty) * 257) >> 8; // from 0 - 255 (with 8 fractional bits) to 0 - 65535
+}
+
+//** - PID - **********************************************************************************************************************************************************************
+
+void control::PID::setGains(uint16_t kp, uint16_t ki, uint16_t kd) {
+  pid_kp = kp;
+  pid_ki = ki;
+  pid_kd = kd;
+}
+
+void control::PID::reset() {
+  pid_integral = 0;
+  pid_derivative = 0;
+  pid_hasMeasured = false;
+  pid_output = 0;
+}
+
+int16_t control::PID::update(int16_t setpoint, int16_t measured, uint32_t dt) {
+  constexpr int64_t MINUTE = 60000; // ms
+
+  if (dt == 0) return pid_output;
+
+  int32_t outputMax = pid_outputMax;
+  int32_t integralMax = outputMax << 8; // with 8 fractional bits, like the integral
+  int64_t perMinute = MINUTE << pid_fractionBits; // turns (gain * error * ms) into output per minute, without the fractional bits
+
+  int32_t error = static_cast<int32_t>(setpoint) - measured;
+  int32_t proportional = (static_cast<int32_t>(pid_kp) * error) >> pid_fractionBits;
+  int32_t integral = std::clamp(pid_integral + static_cast<int32_t>((static_cast<int64_t>(pid_ki) * error * dt * 256) / perMinute), -integralMax, integralMax);
+
+  if (pid_hasMeasured) { // on the measurement, not the error, so changing the setpoint doesn't kick the output
+    int32_t rawDerivative = -static_cast<int32_t>((static_cast<int64_t>(pid_kd) * (measured - pid_lastMeasured) * MINUTE) / (static_cast<int64_t>(dt) << pid_fractionBits));
+    pid_derivative += (rawDerivative - pid_derivative) / pid_derivativeFilter;
+  }
+
+  int32_t derivative = pid_derivative;
+
+  // only let the integral grow as far as it takes the output to reach a limit, so it doesn't wind up (but the output can still get all the way there)
+  int32_t rest = std::clamp(proportional + derivative, -2 * outputMax, 2 * outputMax); // the integral can't go past the output limits anyway, so this can't overflow when shifted
+  if (error > 0) integral = std::min(integral, std::max(pid_integral, (outputMax - rest) * 256));
+  else if (error < 0) integral = std::max(integral, std::min(pid_integral, (-outputMax - rest) * 256));
+
+  pid_integral = integral;
+
+  int32_t output = proportional + (pid_integral >> 8) + derivative;
+
+  pid_lastMeasured = measured;
+  pid_hasMeasured = true;
+  pid_output = std::clamp(output, -outputMax, outputMax);
+
+  return pid_output;
+}
+
+int16_t control::PID::getOutput() const {
+  return pid_output;
+}
+
+//** - RelayAutotune - ************************************************************************************************************************************************************
+
+void control::RelayAutotune::start(int16_t setpoint, int16_t measured) {
+  relayAutotune_setpoint = setpoint;
+  relayAutotune_output = (measured < setpoint) ? relayAutotune_relayOutput : -relayAutotune_relayOutput;
+  relayAutotune_risen = false;
+  relayAutotune_max = measured;
+  relayAutotune_min = measured;
+  relayAutotune_cyclesDone = 0;
+  relayAutotune_periodSum = 0;
+  relayAutotune_amplitudeSum = 0;
+}
+
+int16_t control::RelayAutotune::update(int16_t measured, uint32_t now) {
+  if (isDone()) return relayAutotune_output;
+
+  relayAutotune_max = std::max(relayAutotune_max, measured);
+  relayAutotune_min = std::min(relayAutotune_min, measured);
+
+  if (relayAutotune_output > 0 && measured > (relayAutotune_setpoint + relayAutotune_hysteresis)) { // heated past the setpoint; start cooling
+    relayAutotune_output = -relayAutotune_relayOutput;
+
+  } else if (relayAutotune_output < 0 && measured < (relayAutotune_setpoint - relayAutotune_hysteresis)) { // cooled past the setpoint; start heating | this ends an oscillation
+    relayAutotune_output = relayAutotune_relayOutput;
+
+    if (relayAutotune_risen) {
+      relayAutotune_cyclesDone++;
+
+      if (relayAutotune_cyclesDone > 1) { // the first one started from wherever the measurement was, so it isn't a real oscillation
+        relayAutotune_periodSum += now - relayAutotune_lastRise;
+        relayAutotune_amplitudeSum += relayAutotune_max - relayAutotune_min;
+      }
+    }
+
+    relayAutotune_risen = true;
+    relayAutotune_lastRise = now;
+    relayAutotune_max = measured;
+    relayAutotune_min = measured;
+  }
+
+  return relayAutotune_output;
+}
+
+int16_t control::RelayAutotune::getOutput() const {
+  return relayAutotune_output;
+}
+
+bool control::RelayAutotune::isDone() const {
+  return relayAutotune_cyclesDone > relayAutotune_cycles;
+}
+
+bool control::RelayAutotune::getGains(uint16_t& kp, uint16_t& ki, uint16_t& kd) const {
+  constexpr int64_t MINUTE = 60000; // ms
+  constexpr int64_t PI_1000 = 3142; // pi, times 1000
+
+  if (!isDone() || relayAutotune_amplitudeSum <= 0 || relayAutotune_periodSum == 0) return false;
+
+  int64_t cycles = relayAutotune_cycles;
+  int64_t period = relayAutotune_periodSum / cycles; // ms
+  int64_t amplitude = relayAutotune_amplitudeSum; // peak to peak, summed over <cycles> | so the half amplitude is amplitude / (2 * cycles)
+
+  // the ultimate gain is 4 * relayOutput / (pi * half amplitude); Tyreus-Luyben: kp = ku / 2.2, ti = 2.2 * tu, td = tu / 6.3
+  int64_t ultimateGain_1000 = (4 * static_cast<int64_t>(relayAutotune_relayOutput) * 2 * cycles * 1000 * 1000 << relayAutotune_fractionBits) / (PI_1000 * amplitude); // output per unit, times 1000
+  int64_t proportional = (ultimateGain_1000 * 10) / (22 * 1000);
+  int64_t integral = (proportional * MINUTE * 10) / (22 * period); // per minute
+  int64_t derivative = (proportional * period * 10) / (63 * MINUTE); // minutes
+
+  if (proportional <= 0) return false; // the oscillation was too big to give a usable gain
+
+  kp = std::min(proportional, static_cast<int64_t>(UINT16_MAX));
+  ki = std::min(integral, static_cast<int64_t>(UINT16_MAX));
+  kd = std::min(derivative, static_cast<int64_t>(UINT16_MAX));
+
+  return true;
+}
+
+//** - SlowPWM - ******************************************************************************************************************************************************************
+
+void heaters::SlowPWM::setDemand(uint16_t demand) {
+  slowPWM_demand = std::min(demand, slowPWM_demandMax);
+}
+
+uint16_t heaters::SlowPWM::getDemand() const {
+  return slowPWM_demand;
+}
+
+void heaters::SlowPWM::stop() {
+  slowPWM_demand = 0;
+  slowPWM_stopRequested = true;
+}
+
+bool heaters::SlowPWM::update(uint32_t now) {
+  uint32_t window = std::max(slowPWM_windowVar->load(), static_cast<uint16_t>(1));
+  uint32_t minOn = std::min(static_cast<uint32_t>(slowPWM_minOnVar->load()), window / 2); // so there is always a way to give the demand on average
+  uint32_t minOff = std::min(static_cast<uint32_t>(slowPWM_minOffVar->load()), window / 2);
+  uint32_t demand = slowPWM_demand;
+
+  if (!slowPWM_started || slowPWM_stopRequested.exchange(false)) { // start over
+    if (slowPWM_started) { // stopped; turn off now
+      slowPWM_on = false;
+      slowPWM_switchTime = now;
+
+    } else { // it has been off since startup, so it can turn on right away
+      slowPWM_switchTime = now - minOff;
+    }
+
+    slowPWM_started = true;
+    slowPWM_windowStart = now;
+    slowPWM_lastUpdate = now;
+    slowPWM_carry = 0;
+    slowPWM_onTime = 0;
+    slowPWM_demandTime = 0;
+  }
+
+  uint32_t elapsed = now - slowPWM_lastUpdate;
+  slowPWM_lastUpdate = now;
+  if (slowPWM_on) {
+    slowPWM_onTime += elapsed;
+    slowPWM_totalOnTime += elapsed;
+  }
+  slowPWM_demandTime += demand * elapsed;
+
+  if (now - slowPWM_windowStart >= window) { // start a new window, carrying over whatever on time the last one was off by
+    int32_t owed = static_cast<int32_t>(slowPWM_demandTime / slowPWM_demandMax) - static_cast<int32_t>(slowPWM_onTime);
+    slowPWM_carry = std::clamp(slowPWM_carry + owed, -static_cast<int32_t>(window), static_cast<int32_t>(window));
+    slowPWM_windowStart = (now - slowPWM_windowStart >= 2 * window) ? now : slowPWM_windowStart + window; // don't try to catch up on missed windows
+    slowPWM_onTime = 0;
+    slowPWM_demandTime = 0;
+  }
+
+  int32_t onTime; // how long the heater should be on this window
+
+  if (demand == 0 || demand >= slowPWM_demandMax) { // fully off or on; nothing to carry
+    onTime = (demand == 0) ? 0 : window;
+    slowPWM_carry = 0;
+
+  } else {
+    onTime = static_cast<int32_t>((demand * window) / slowPWM_demandMax) + slowPWM_carry;
+
+    if (onTime < static_cast<int32_t>(minOn)) onTime = 0; // too short to turn on for; save it up
+    else if (onTime > static_cast<int32_t>(window - minOff)) onTime = window; // too short to turn off for
+  }
+
+  bool shouldBeOn = static_cast<int32_t>(now - slowPWM_windowStart) < onTime;
+
+  if (shouldBeOn != slowPWM_on && (now - slowPWM_switchTime) >= (slowPWM_on ? minOn : minOff)) {
+    slowPWM_on = shouldBeOn;
+    slowPWM_switchTime = now;
+  }
+
+  return slowPWM_on;
+}
+
+bool heaters::SlowPWM::isOn() const {
+  return slowPWM_on;
+}
+
+uint32_t heaters::SlowPWM::getTotalOnTime() const {
+  return slowPWM_totalOnTime;
+}
+
+//** - Stager - *******************************************************************************************************************************************************************
+
+void heaters::Stager::reset() {
+  stager_errorStaged = false;
+  stager_riseStaged = false;
+  stager_timingRise = false;
+}
+
+bool heaters::Stager::update(uint16_t demand, int16_t error, int16_t measured, uint32_t now) {
+  int32_t stageError = static_cast<int32_t>(stager_stageErrorVar->load()) << stager_fractionBits;
+  int64_t minRise = stager_minRiseVar->load(); // tenths of a unit per minute
+
+  // a big error: on at the stage 2 error, off below half of it
+  if (stageError > 0 && error >= stageError) stager_errorStaged = true;
+  else if (stageError == 0 || error < stageError / 2) stager_errorStaged = false;
+
+  // a slow rise: on if the first heater alone, fully on, can't warm fast enough; off once the target is reached
+  if (error <= 0 || minRise == 0) stager_riseStaged = false;
+
+  if (demand < stager_demandMax || isStaged()) { // only the first heater alone at full tells us anything
+    stager_timingRise = false;
+
+  } else if (!stager_timingRise) {
+    stager_timingRise = true;
+    stager_riseStart = now;
+    stager_riseStartMeasured = measured;
+
+  } else if (now - stager_riseStart >= stager_rateTime) {
+    int64_t rise = measured - stager_riseStartMeasured;
+
+    if (minRise > 0 && rise * 600000 < ((minRise << stager_fractionBits) * stager_rateTime)) stager_riseStaged = true; // rise / rateTime < minRise / 10 / 60000
+
+    stager_riseStart = now; // time the next stretch
+    stager_riseStartMeasured = measured;
+  }
+
+  return isStaged();
+}
+
+bool heaters::Stager::isStaged() const {
+  return stager_errorStaged || stager_riseStaged;
+}
@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+// the parts of the firmware that are pure logic: they only work on the values they are given (and the settings they point to), and never use the Arduino core, the Pico SDK, or the clock
+// keep it that way; the host tests in test/ build this file on its own
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace lights {
+  /**
+  * @brief fades a (perceptual) brightness level towards a target at a set rate, one tick at a time
+  * @note the level is kept with 16 fractional bits, so slow fades still move a little every tick
+  */
+  class FadeStepper {
+    public:
+      FadeStepper() : fadeStepper_level(0), fadeStepper_target(0), fadeStepper_increment(FULL) {}
+
+      /**
+      * @brief starts fading from the current level to a new one
+      * @param target the level to fade to
+      * @param fullFadeTicks how many ticks a fade all the way from 0 to 255 would take (shorter fades take proportionally less) | 0 jumps straight to the target on the next tick
+      */
+      void start(uint8_t target, uint32_t fullFadeTicks) {
+        fadeStepper_target = static_cast<uint32_t>(target) << 16;
+        fadeStepper_increment = (fullFadeTicks == 0) ? FULL : std::max(FULL / fullFadeTicks, static_cast<uint32_t>(1));
+      }
+
+      /**
+      * @brief jumps straight to a level, ending any fade
+      */
+      void setLevel(uint8_t level) {
+        fadeStepper_level = static_cast<uint32_t>(level) << 16;
+        fadeStepper_target = fadeStepper_level;
+      }
+
+      /**
+      * @brief jumps straight to a level with 8 fractional bits (0 - 65280), ending any fade
+      */
+      void setFineLevel(uint16_t fineLevel) {
+        fadeStepper_level = static_cast<uint32_t>(fineLevel) << 8;
+        fadeStepper_target = fadeStepper_level;
+      }
+
+      /**
+      * @brief advances the fade by one tick
+      * @return true if the level changed
+      */
+      bool step() {
+        uint32_t level = fadeStepper_level;
+        uint32_t target = fadeStepper_target;
+
+        if (level == target) return false; // nothing to do
+
+        if (level < target) {
+          level = ((target - level) > fadeStepper_increment) ? (level + fadeStepper_increment) : target;
+
+        } else {
+          level = ((level - target) > fadeStepper_increment) ? (level - fadeStepper_increment) : target;
+        }
+
+        fadeStepper_level = level;
+        return true;
+      }
+
+      /**
+      * @brief returns the current level (0 - 255)
+      */
+      uint8_t getLevel() const {
+        return fadeStepper_level >> 16;
+      }
+
+      /**
+      * @brief returns the current level with 8 fractional bits (0 - 65280)
+      */
+      uint16_t getFineLevel() const {
+        return fadeStepper_level >> 8;
+      }
+
+      /**
+      * @brief returns true if the level has reached the target
+      */
+      bool isDone() const {
+        return fadeStepper_level == fadeStepper_target;
+      }
+
+    private:
+      static constexpr uint32_t FULL = static_cast<uint32_t>(255) << 16; ///< a full-range fade, with 16 fractional bits
+
+      volatile uint32_t fadeStepper_level; ///< the current level, with 16 fractional bits
+      volatile uint32_t fadeStepper_target; ///< the level being faded to, with 16 fractional bits
+      volatile uint32_t fadeStepper_increment; ///< how far the level moves each tick, with 16 fractional bits
+  };
+
+  /**
+  * @brief one point in a light pattern
+  */
+  struct Keyframe {
+    uint16_t time; ///< the time (ms) from the start of the pattern that the light reaches this level
+    uint8_t level; ///< the brightness (0 - 255, as a fraction of the light's level) at this point
+  };
+
+  /**
+  * @brief a looping light pattern | keep the keyframes const so they stay in flash
+  * @note the first keyframe should be at time 0, and the last one's time is the length of the pattern (give it the same level as the first one for a seamless loop). Two keyframes at the same time make a step
+  */
+  struct Pattern {
+    const Keyframe* keyframes; ///< the keyframes, in time order
+    uint8_t keyframeCount; ///< the number of keyframes
+  };
+
+  /**
+  * @brief finds a pattern's brightness at a point in time, interpolating between keyframes
+  * @param pattern the pattern
+  * @param elapsed the time (ms) since the pattern started
+  * @return the brightness with 8 fractional bits (0 - 65280)
+  */
+  uint16_t patternLevel(const Pattern& pattern, uint32_t elapsed);
+
+  /**
+  * @brief converts a perceptual brightness level to a linear, 16-bit PWM duty cycle (CIE 1931 lightness), interpolating between table entries
+  * @param fineLevel the level with 8 fractional bits (0 - 65280, like FadeStepper::getFineLevel())
+  * @return the duty cycle, 0 - 65535
+  */
+  uint16_t levelToDuty(uint16_t fineLevel);
+}
+
+namespace servos {
+  /**
+  * @brief plans a servo's move with a trapezoidal speed profile (speeds up, cruises, slows down), and finds where the servo should be at any time
+  */
+  class Trajectory {
+    public:
+      Trajectory() : trajectory_from(0), trajectory_target(0), trajectory_direction(1), trajectory_startTime(0), trajectory_acceleration(0),
+        trajectory_peakSpeed(0), trajectory_accelTime(0), trajectory_accelDistance(0), trajectory_duration(0) {}
+
+      /**
+      * @brief jumps straight to a position, ending any move
+      */
+      void setPosition(uint8_t position);
+
+      /**
+      * @brief starts a move from wherever the servo is at <now> to a new position
+      * @param target the position (deg.) to move to
+      * @param now the current time (ms)
+      * @param msPerDegree the cruising speed, in milliseconds per degree | 0 jumps straight to the target
+      * @param acceleration how fast the speed changes, in degrees per second per second | 0 moves at the cruising speed the whole way
+      * @note the move starts from rest, even if the servo was already moving
+      */
+      void start(uint8_t target, uint32_t now, uint16_t msPerDegree, uint16_t acceleration);
+
+      /**
+      * @brief returns the position (deg.) the servo should be at at a given time
+      */
+      uint8_t getPosition(uint32_t now) const;
+
+      /**
+      * @brief returns the position the servo is moving to
+      */
+      uint8_t getTarget() const;
+
+      /**
+      * @brief returns true if the move is over at a given time
+      */
+      bool isDone(uint32_t now) const;
+
+    private:
+      uint8_t trajectory_from; ///< the position the move started at
+      uint8_t trajectory_target; ///< the position the move ends at
+      int8_t trajectory_direction; ///< 1 if the position is increasing, -1 if it is decreasing
+      uint32_t trajectory_startTime; ///< when the move started (ms)
+      float trajectory_acceleration; ///< deg. / ms / ms
+      float trajectory_peakSpeed; ///< the fastest the move gets (deg. / ms)
+      float trajectory_accelTime; ///< how long speeding up (and slowing down) takes (ms)
+      float trajectory_accelDistance; ///< how far the servo moves while speeding up (and slowing down) (deg.)
+      float trajectory_duration; ///< how long the whole move takes (ms)
+  };
+}
+
+namespace fans {
+  /**
+  * @brief converts a number of tachometer pulses counted over some time to RPM
+  * @param pulses the number of pulses counted
+  * @param interval the time (in microseconds) they were counted over
+  * @param pulsesPerRev how many pulses the fan gives each revolution (usually 2)
+  * @return the speed, in RPM (0 if interval or pulsesPerRev are 0, at most 65535)
+  */
+  uint16_t pulsesToRPM(uint32_t pulses, uint32_t interval, uint8_t pulsesPerRev);
+
+  /**
+  * @brief one point on a fan curve
+  */
+  struct CurvePoint {
+    uint8_t error; ///< how far (deg. c.) the temperature is above the target
+    uint8_t airflow; ///< the airflow at that error
+  };
+
+  /**
+  * @brief finds the airflow for a temperature error by interpolating between the points of a fan curve (with integer math)
+  * @param points the curve, in order of increasing error
+  * @param count the number of points
+  * @param error how far the temperature is above the target, with <fractionBits> fractional bits
+  * @param fractionBits the number of fractional bits in error
+  * @return the airflow (the first point's below the curve, the last point's above it)
+  */
+  uint8_t evaluateCurve(const CurvePoint* points, uint8_t count, int32_t error, uint8_t fractionBits);
+
+  /**
+  * @brief finds the speed to run a fan at, so it is never asked to turn too slowly to keep going
+  * @param target the speed asked for (any unit, e.g. RPM or duty)
+  * @param cap the most the fan may run at
+  * @param floor the least the fan keeps turning at
+  * @return <target> kept between <floor> and <cap>, or 0 (off) if <target> is 0, or if the fan can't turn slowly enough to stay under <cap>
+  */
+  uint16_t runningSpeed(uint16_t target, uint16_t cap, uint16_t floor);
+
+  /**
+  * @brief finds the lowest airflow (other than off) that runs a fan at least at some speed
+  * @param minRPM the speed (RPM) the airflow has to give
+  * @param maxRPM the fan's speed at full duty (airflow is a fraction of this)
+  * @return the airflow (0 - 255), rounded up (255 if the fan can't reach <minRPM>)
+  */
+  uint8_t lowestAirflow(uint16_t minRPM, uint16_t maxRPM);
+
+  /**
+  * @brief how to run a fan: held at a speed, or at a fixed duty cycle
+  */
+  struct SpeedPlan {
+    bool closedLoop; ///< true to hold the fan at <speed> (RPM), false to run it at <speed> as a duty cycle (0 - 255)
+    uint16_t speed; ///< the speed or duty cycle | 0 is off
+  };
+
+  /**
+  * @brief works out how to run a fan for a target | an airflow can only be held in closed loop while the fan's speed is being measured, so otherwise it is run as a duty cycle (open loop)
+  * @param target the airflow or duty cycle (0 - 255, a fraction of <maxRPM> or of full duty)
+  * @param cap the max fan speed (0 - 255, the same way)
+  * @param airflow true if <target> is an airflow, false if it is a duty cycle
+  * @param measured true if the fan's speed is known (it has a tachometer, and a reading has shown it turning)
+  * @param maxRPM the fan's speed at full duty
+  * @param minRPM the least speed the fan is held at (closed loop)
+  * @param minDuty the least duty cycle the fan keeps turning at (open loop)
+  * @return the plan (see runningSpeed())
+  */
+  SpeedPlan planSpeed(uint8_t target, uint8_t cap, bool airflow, bool measured, uint16_t maxRPM, uint16_t minRPM, uint8_t minDuty);
+
+  /**
+  * @brief a PI controller that finds the duty cycle needed to hold a fan at a target speed
+  * @note the output starts from a feed-forward guess (as if speed were proportional to duty), and the integral learns how far off the fan is, so it carries over between targets
+  */
+  class RPMController {
+    public:
+      /**
+      * @param kp the proportional gain, in 1/256ths of a duty step per RPM of error
+      * @param ki the integral gain, in 1/256ths of a duty step per RPM of error per update
+      */
+      RPMController(uint16_t kp, uint16_t ki) : rpmController_kp(kp), rpmController_ki(ki), rpmController_integral(0) {}
+
+      /**
+      * @brief forgets what the integral has learned
+      */
+      void reset() {
+        rpmController_integral = 0;
+      }
+
+      /**
+      * @brief finds the next duty cycle | call once per new speed reading
+      * @param target the speed (RPM) to hold
+      * @param measured the speed (RPM) the fan is at
+      * @param maxRPM the fan's speed at full duty (used for the feed-forward guess)
+      * @param minDuty the lowest duty cycle (0 - 255) to give, so the fan doesn't stall | the integral doesn't wind up while the output is held there
+      * @return the duty cycle (0 - 65535)
+      */
+      uint16_t update(uint16_t target, uint16_t measured, uint16_t maxRPM, uint8_t minDuty);
+
+    private:
+      const uint16_t rpmController_kp; ///< the proportional gain
+      const uint16_t rpmController_ki; ///< the integral gain
+      int32_t rpmController_integral; ///< the integral term, in 1/256ths of a duty step
+  };
+}
+
+namespace control {
+  /**
+  * @brief a fixed-point PID controller with anti-windup and derivative on measurement
+  * @note the gains are per minute, so they don't change with how often it is updated
+  */
+  class PID {
+    public:
+      /**
+      * @param fractionBits the number of fractional bits in the setpoint and measurement
+      * @param outputMax the output is limited to -outputMax - outputMax
+      * @param derivativeFilter the derivative is low-pass filtered over about this many updates (a sensor's steps are big next to how fast the temperature changes) | 1 doesn't filter it
+      */
+      PID(uint8_t fractionBits, int16_t outputMax, uint8_t derivativeFilter) : pid_fractionBits(fractionBits), pid_outputMax(outputMax),
+        pid_derivativeFilter(std::max(derivativeFilter, static_cast<uint8_t>(1))), pid_kp(0), pid_ki(0), pid_kd(0),
+        pid_integral(0), pid_derivative(0), pid_lastMeasured(0), pid_hasMeasured(false), pid_output(0) {}
+
+      /**
+      * @brief sets the gains | takes effect at the next update
+      * @param kp the proportional gain, in output per unit (e.g. deg. c.) of error
+      * @param ki the integral gain, in output per unit of error per minute
+      * @param kd the derivative gain, in output per unit per minute of change in the measurement
+      */
+      void setGains(uint16_t kp, uint16_t ki, uint16_t kd);
+
+      /**
+      * @brief forgets the integral and the last measurement
+      */
+      void reset();
+
+      /**
+      * @brief finds the next output | call once per new measurement
+      * @param setpoint the target, with <fractionBits> fractional bits
+      * @param measured the measurement, with <fractionBits> fractional bits
+      * @param dt the time (ms) since the last update
+      * @return the output, -outputMax - outputMax
+      */
+      int16_t update(int16_t setpoint, int16_t measured, uint32_t dt);
+
+      /**
+      * @brief returns the last output
+      */
+      int16_t getOutput() const;
+
+    private:
+      const uint8_t pid_fractionBits; ///< the number of fractional bits in the setpoint and measurement
+      const int16_t pid_outputMax; ///< the largest output (either way)
+      const int32_t pid_derivativeFilter; ///< how many updates the derivative is filtered over
+      uint16_t pid_kp; ///< the proportional gain
+      uint16_t pid_ki; ///< the integral gain
+      uint16_t pid_kd; ///< the derivative gain
+      int32_t pid_integral; ///< the integral term, with 8 fractional bits
+      int32_t pid_derivative; ///< the derivative term, filtered
+      int16_t pid_lastMeasured; ///< the measurement at the last update
+      bool pid_hasMeasured; ///< false until the first update (so there is no derivative kick)
+      int16_t pid_output; ///< the last output
+  };
+
+  /**
+  * @brief finds PID gains with the relay method: switches the output between +relayOutput and -relayOutput around the setpoint, and measures the oscillation that causes
+  * @note the gains are found with the Tyreus-Luyben rules, which overshoot less than Ziegler-Nichols (thermal systems don't like overshoot)
+  */
+  class RelayAutotune {
+    public:
+      /**
+      * @param fractionBits the number of fractional bits in the setpoint and measurement
+      * @param relayOutput the output while heating (and, negated, while cooling)
+      * @param hysteresis how far (with <fractionBits> fractional bits) the measurement has to cross the setpoint before the output switches, so noise doesn't switch it
+      * @param cycles how many full oscillations to measure | the first one (from wherever the measurement started) isn't counted
+      */
+      RelayAutotune(uint8_t fractionBits, int16_t relayOutput, int16_t hysteresis, uint8_t cycles) : relayAutotune_fractionBits(fractionBits), relayAutotune_relayOutput(relayOutput),
+        relayAutotune_hysteresis(hysteresis), relayAutotune_cycles(cycles), relayAutotune_setpoint(0), relayAutotune_output(0), relayAutotune_lastRise(0), relayAutotune_risen(false),
+        relayAutotune_max(0), relayAutotune_min(0), relayAutotune_cyclesDone(0), relayAutotune_periodSum(0), relayAutotune_amplitudeSum(0) {}
+
+      /**
+      * @brief starts a new tune, forgetting any old one
+      * @param setpoint the target to oscillate around, with <fractionBits> fractional bits
+      * @param measured the measurement now, with <fractionBits> fractional bits
+      */
+      void start(int16_t setpoint, int16_t measured);
+
+      /**
+      * @brief switches the output if the measurement has crossed the setpoint, and records the oscillation | call once per new measurement
+      * @param measured the measurement, with <fractionBits> fractional bits
+      * @param now the current time (ms)
+      * @return the output
+      */
+      int16_t update(int16_t measured, uint32_t now);
+
+      /**
+      * @brief returns the output (+relayOutput or -relayOutput)
+      */
+      int16_t getOutput() const;
+
+      /**
+      * @brief returns true once enough oscillations have been measured
+      */
+      bool isDone() const;
+
+      /**
+      * @brief finds the gains (in the units control::PID uses) from the measured oscillations
+      * @return false if there weren't enough oscillations, or they were too small to use
+      */
+      bool getGains(uint16_t& kp, uint16_t& ki, uint16_t& kd) const;
+
+    private:
+      const uint8_t relayAutotune_fractionBits; ///< the number of fractional bits in the setpoint and measurement
+      const int16_t relayAutotune_relayOutput; ///< the output while heating
+      const int16_t relayAutotune_hysteresis; ///< how far the measurement has to cross the setpoint
+      const uint8_t relayAutotune_cycles; ///< how many oscillations to measure
+      int16_t relayAutotune_setpoint; ///< the target
+      int16_t relayAutotune_output; ///< the current output
+      uint32_t relayAutotune_lastRise; ///< when the output last switched to heating (ms)
+      bool relayAutotune_risen; ///< true once the output has switched to heating at least once
+      int16_t relayAutotune_max; ///< the highest measurement this oscillation
+      int16_t relayAutotune_min; ///< the lowest measurement this oscillation
+      uint8_t relayAutotune_cyclesDone; ///< how many oscillations have been measured (including the first, uncounted one)
+      uint32_t relayAutotune_periodSum; ///< the sum of the counted oscillations' periods (ms)
+      int32_t relayAutotune_amplitudeSum; ///< the sum of the counted oscillations' peak to peak amplitudes
+  };
+}
+
+namespace heaters {
+  /**
+  * @brief turns a heater demand into slow on / off periods (time-proportioning over a window), never switching sooner than the minimum on and off times allow
+  * @note on times the minimum times round away are carried over into the next windows, so the average stays right | setDemand() and stop() may be called while update() runs from a timer
+  */
+  class SlowPWM {
+    public:
+      /**
+      * @param windowVar a pointer to the variable holding the window time (ms)
+      * @param minOnVar a pointer to the variable holding the minimum on time (ms)
+      * @param minOffVar a pointer to the variable holding the minimum off time (ms)
+      * @param demandMax the demand at which the heater is always on
+      */
+      SlowPWM(std::atomic<uint16_t> *windowVar, std::atomic<uint16_t> *minOnVar, std::atomic<uint16_t> *minOffVar, uint16_t demandMax) : slowPWM_windowVar(windowVar), slowPWM_minOnVar(minOnVar),
+        slowPWM_minOffVar(minOffVar), slowPWM_demandMax(demandMax), slowPWM_demand(0), slowPWM_stopRequested(false), slowPWM_on(false), slowPWM_started(false), slowPWM_switchTime(0),
+        slowPWM_windowStart(0), slowPWM_lastUpdate(0), slowPWM_carry(0), slowPWM_onTime(0), slowPWM_demandTime(0), slowPWM_totalOnTime(0) {}
+
+      /**
+      * @brief sets the demand (0 - demandMax) | takes effect at the next update, without waiting for the window to end
+      */
+      void setDemand(uint16_t demand);
+
+      /**
+      * @brief returns the demand
+      */
+      uint16_t getDemand() const;
+
+      /**
+      * @brief sets the demand to 0 and turns the heater off at the next update, even if it hasn't been on for the minimum on time (for when it isn't safe to keep heating)
+      */
+      void stop();
+
+      /**
+      * @brief finds if the heater should be on now | call often (every HEATER_TICK_INTERVAL ms), and always with the same clock
+      * @param now the current time (ms)
+      * @return true if the heater should be on
+      */
+      bool update(uint32_t now);
+
+      /**
+      * @brief returns true if the heater was on at the last update
+      */
+      bool isOn() const;
+
+      /**
+      * @brief returns how long (ms) the heater has been on in total | wraps around after about 49 days, so only compare two of these by their difference
+      */
+      uint32_t getTotalOnTime() const;
+
+    private:
+      std::atomic<uint16_t> *slowPWM_windowVar; ///< a pointer to the window time (ms)
+      std::atomic<uint16_t> *slowPWM_minOnVar; ///< a pointer to the minimum on time (ms)
+      std::atomic<uint16_t> *slowPWM_minOffVar; ///< a pointer to the minimum off time (ms)
+      const uint16_t slowPWM_demandMax; ///< the demand at which the heater is always on
+      std::atomic<uint16_t> slowPWM_demand; ///< the demand (0 - demandMax)
+      std::atomic<bool> slowPWM_stopRequested; ///< true if stop() was called since the last update
+      bool slowPWM_on; ///< if the heater is on
+      bool slowPWM_started; ///< false until the first update
+      uint32_t slowPWM_switchTime; ///< when the heater last turned on or off (ms)
+      uint32_t slowPWM_windowStart; ///< when this window started (ms)
+      uint32_t slowPWM_lastUpdate; ///< the time of the last update (ms)
+      int32_t slowPWM_carry; ///< on time (ms) owed to (or, if negative, taken from) the windows to come
+      uint32_t slowPWM_onTime; ///< how long (ms) the heater has been on this window
+      uint32_t slowPWM_demandTime; ///< the demand, summed over every ms of this window
+      std::atomic<uint32_t> slowPWM_totalOnTime; ///< how long (ms) the heater has been on in total
+  };
+
+  /**
+  * @brief decides when a second heater (stage 2) should heat along with the first: when the temp is far below the target, or when the first heater alone, fully on, is warming too slowly
+  * @note stage 2 stays on until the error falls below half of the stage 2 error if that turned it on, or until the target is reached if a slow rise did
+  */
+  class Stager {
+    public:
+      /**
+      * @param fractionBits the number of fractional bits in the error and measurement
+      * @param demandMax the demand at which a heater is always on
+      * @param rateTime how long (ms) the first heater has to be fully on before its rise is checked
+      * @param stageErrorVar a pointer to the variable holding the error (in whole units) at or above which stage 2 comes on | 0 turns this off
+      * @param minRiseVar a pointer to the variable holding the slowest rise (in tenths of a unit per minute) that doesn't bring on stage 2 | 0 turns this off
+      */
+      Stager(uint8_t fractionBits, uint16_t demandMax, uint32_t rateTime, std::atomic<uint8_t> *stageErrorVar, std::atomic<uint8_t> *minRiseVar) : stager_fractionBits(fractionBits),
+        stager_demandMax(demandMax), stager_rateTime(rateTime), stager_stageErrorVar(stageErrorVar), stager_minRiseVar(minRiseVar), stager_errorStaged(false), stager_riseStaged(false),
+        stager_timingRise(false), stager_riseStart(0), stager_riseStartMeasured(0) {}
+
+      /**
+      * @brief turns stage 2 off and forgets the rise being timed
+      */
+      void reset();
+
+      /**
+      * @brief decides if stage 2 should be on | call whenever the demand changes or there is a new measurement
+      * @param demand the heat demand (0 - demandMax)
+      * @param error how far the measurement is below the target, with <fractionBits> fractional bits
+      * @param measured the measurement, with <fractionBits> fractional bits
+      * @param now the current time (ms)
+      * @return true if stage 2 should heat along with the first heater
+      */
+      bool update(uint16_t demand, int16_t error, int16_t measured, uint32_t now);
+
+      /**
+      * @brief returns true if stage 2 was on at the last update
+      */
+      bool isStaged() const;
+
+    private:
+      const uint8_t stager_fractionBits; ///< the number of fractional bits in the error and measurement
+      const uint16_t stager_demandMax; ///< the demand at which a heater is always on
+      const uint32_t stager_rateTime; ///< how long (ms) the rise is timed for
+      std::atomic<uint8_t> *stager_stageErrorVar; ///< a pointer to the error that brings on stage 2
+      std::atomic<uint8_t> *stager_minRiseVar; ///< a pointer to the slowest rise that doesn't bring on stage 2
+      bool stager_errorStaged; ///< true if stage 2 is on because of a big error
+      bool stager_riseStaged; ///< true if stage 2 is on because of a slow rise
+      bool stager_timingRise; ///< true while the first heater is fully on and its rise is being timed
+      uint32_t stager_riseStart; ///< when the rise started being timed (ms)
+      int16_t stager_riseStartMeasured; ///< the measurement when the rise started being timed
+  };
+}
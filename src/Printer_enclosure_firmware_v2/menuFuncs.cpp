@@ -37,6 +37,8 @@ void clearName() {
   for (uint8_t i = 0; i != 255; i++) {
     printName[i] = 0;
   }
+
+  printNameChanged = true;
 }
 
 void scrollName(uint8_t height) {
@@ -45,45 +47,49 @@ void scrollName(uint8_t height) {
   Serial.printf("scrollName(%u) called from core%u.\n", height, core); // print a debug message over USB
   #endif
 
-  static uint8_t pos = CHARACTER_WIDTH;
-  static uint8_t startChar = 0;
+  constexpr uint16_t stripWidth = (255 * CHARACTER_WIDTH) + NAME_SCROLL_GAP; // room for the longest posible name, followed by the gap
+
+  static uint8_t strip[stripWidth]; // the print name, rendered once into a single page of pixels
+  static uint16_t nameWidth = 0; // the width of the rendered print name, in pixels
+  static uint16_t pos = 0; // how many pixels the name has scrolled to the left
   static timers::Timer updateTimer;
 
-  if (!updateTimer.isDone() && updateTimer.isSet() && dispLastLoop) return; // if enough time hasn't elapsed since the last movement of the cursor, return
+  if (printNameChanged.exchange(false) || !dispLastLoop) { // if the print name was changed, or wasn't displayed last loop, render it (again)
+    memset(strip, 0, stripWidth);
+    nameWidth = 0;
 
-  display.setTextSize(1); // normal (1x) text size
+    for (uint8_t i = 0; i < 255; i++) { // for each character in the print name
+      char c = printName[i];
+      if (c == '\0') break; // stop if the end of the text is reached
 
-  if (!dispLastLoop) { // if the print name wasn't displayed last loop
-    // reset the variables to their start values
-    pos = CHARACTER_WIDTH;
-    startChar = 0;
-    updateTimer.set(nameScrollSpeed);
+      nameWidth = text::drawStripChar(strip, stripWidth, nameWidth, c);
+    }
 
-  } else {
-    uint32_t overdoneTime = updateTimer.overdone();
-    updateTimer.set(nameScrollSpeed - min(static_cast<uint32_t>(nameScrollSpeed.load()), overdoneTime));
+    if (!dispLastLoop) pos = 0; // start from the begining if the name wasn't being displayed
   }
 
-  if (pos == 0) { // if the first character is all the way to the left
-    pos = CHARACTER_WIDTH - 1; // set the first character to one character's width from the left
-    startChar++; // move the first character to be displayed to the next one
-
-    if (printName[startChar] == '\0') { // if the end of the text is reached
-      startChar = 0;  // reset back to the start of the text
-    }
-  } else { // if the first character isn't all the way to the left
-    pos--; // move it one pixel to the left
+  if (nameWidth <= SCREEN_WIDTH) { // if the whole name fits on the screen there is no need to scroll it
+    text::drawColumns(display.getBuffer(), 0, height, strip, nameWidth);
+    return;
   }
 
-  display.setCursor(pos, height);  // set the cursor
+  uint16_t wrapWidth = nameWidth + NAME_SCROLL_GAP; // the distance the name scrolls before it comes back around to where it started
 
-  // draw the visible text
-  for (uint8_t i = 0; i < 20; i++) { // repeat for the visible part of the text
-    uint8_t charIndex = startChar + i;
-    if (printName[charIndex] == '\0') break; // stop if the end of the text is reached
+  if (!dispLastLoop || !updateTimer.isSet()) {
+    updateTimer.set(nameScrollSpeed);
 
-    display.print(printName[charIndex]); // print one character
+  } else if (updateTimer.isDone()) { // if it's time to move the name
+    uint32_t overdoneTime = updateTimer.overdone();
+    updateTimer.set(nameScrollSpeed - min(static_cast<uint32_t>(nameScrollSpeed.load()), overdoneTime));
+    pos++; // move it one pixel to the left
   }
+
+  if (pos >= wrapWidth) pos = 0; // go back to the start once everything (and the gap after it) has scrolled past
+
+  // copy the visible part of the strip onto the screen, wrapping around to the start of the strip if needed
+  uint16_t firstPart = min(static_cast<uint16_t>(wrapWidth - pos), static_cast<uint16_t>(SCREEN_WIDTH));
+  text::drawColumns(display.getBuffer(), 0, height, strip + pos, firstPart);
+  text::drawColumns(display.getBuffer(), firstPart, height, strip, SCREEN_WIDTH - firstPart);
 }
 
 void printHeader() {
@@ -95,46 +101,40 @@ void printHeader() {
   const uint8_t whereToPrintDeg = (SCREEN_WIDTH - 6);
   const uint8_t whereToPrintTemp = (SCREEN_WIDTH - 66);
 
-  display.setTextSize(2); // 2x normal size text
-  display.setTextColor(SSD1306_WHITE, SSD1306_BLACK); // white text on a black background
-  display.setCursor(0, 0); // set the cursor in the upper-left hand corner of the display
-  display.print(modeStrings[mode]); // print the mode (formated in a lovely string, not a number)
+  uint8_t* buffer = display.getBuffer();
+  int16_t x; // where to draw the next character
+
+  text::drawString(buffer, 0, 0, modeStrings[mode].c_str(), 2, false); // draw the mode in 2x size text (formated in a lovely string, not a number)
 
   switch (mode) {
     case MODE_PRINTING: // if the mode is printing
-      display.setCursor(whereToPrintTemp, 0); // move the cursor to near the right-hand side of the display (still at the top)
-      display.print(static_cast<int8_t>(inTemp)); // print the inside temperature
-      display.print("/"); // realy? you can't figure this one out? it prints a "/"
-      display.print(globalSetTemp); // print the target temperature (the set temp)
+      x = text::drawInt(buffer, whereToPrintTemp, 0, static_cast<int8_t>(inTemp), 2, false); // draw the inside temperature near the right-hand side of the display (still at the top)
+      x = text::drawChar(buffer, x, 0, '/', 2, false); // realy? you can't figure this one out? it draws a "/"
+      text::drawInt(buffer, x, 0, globalSetTemp, 2, false); // draw the target temperature (the set temp)
       break;
     
     case MODE_COOLDOWN: // if the mode is cooldown
-      display.setCursor(whereToPrintTemp, 0); // move the cursor to near the right-hand side of the display (still at the top)
-      display.print(static_cast<int8_t>(inTemp)); // print the inside temperature
-      display.print("/");
-      display.print(outTemp); // print the target temperature (the outside temperature)
+      x = text::drawInt(buffer, whereToPrintTemp, 0, static_cast<int8_t>(inTemp), 2, false); // draw the inside temperature near the right-hand side of the display (still at the top)
+      x = text::drawChar(buffer, x, 0, '/', 2, false);
+      text::drawInt(buffer, x, 0, outTemp, 2, false); // draw the target temperature (the outside temperature)
       break;
     
     default: // if the mode is anything else (standby)
-      display.setCursor((whereToPrintTemp + 36), 0); // one double-size character is 12 pixels wide, so three are 36 pixels wide
-      display.print(static_cast<int8_t>(inTemp));
+      text::drawInt(buffer, (whereToPrintTemp + 36), 0, static_cast<int8_t>(inTemp), 2, false); // one double-size character is 12 pixels wide, so three are 36 pixels wide
       break;
   }
   
-  display.setTextSize(1); // normal text size (we were at 2x size)
-  display.setCursor(whereToPrintDeg, 0);
-  display.print("o"); // print a "o"
+  text::drawChar(buffer, whereToPrintDeg, 0, 'o', 1, false); // draw a normal size "o"
 }
 
 void PrintMenuItem(uint8_t index, uint8_t height, bool topItem) {
   if ((index >= menuLength) || (height >= SCREEN_HEIGHT)) setError(14, 3, false); // invalid parameters passed
 
-  String toPrint = " "; // by default, we print a blank space before the menu item name
-  uint16_t textColor = SSD1306_WHITE; // by default, use white text
-  uint16_t backgroundColor = SSD1306_BLACK; // by default, use black background
+  const char* indicator = " "; // by default, we print a blank space before the menu item name
+  bool invert = false; // by default, use white text on a black background
 
   if (index == selectedItem) { // if this menu item is selected:
-    toPrint = MENU_SELLECTED_INDICATOR; // indicate it is sellected
+    indicator = MENU_SELLECTED_INDICATOR; // indicate it is sellected
 
     if (editingMenuItem) { // if we are editing this menu item (if it is clicked on):
       if (topItem) { // if the menu item is at the top of the screen
@@ -144,22 +144,33 @@ void PrintMenuItem(uint8_t index, uint8_t height, bool topItem) {
         display.fillRect(0, height - 1, SCREEN_WIDTH, CHARACTER_HEIGHT + 1, SSD1306_WHITE); // Draw a white rectangle to indicate menu item being sellected
       }
 
-      textColor = SSD1306_BLACK; // in this case we use black text
-      backgroundColor = SSD1306_WHITE; // in this case we use a white background
+      invert = true; // in this case we use black text on a white background
     }
   }
 
-  toPrint.concat(mainMenu[index]->getName()); // add the menu item's name to the String to be printed
-  display.setCursor(0, height); // set the cursor to the left-hand side of the screen, at the correct height
-  display.setTextColor(textColor, backgroundColor); // set text and background colors
-  display.print(toPrint); // print the complete String
-  display.setCursor(SCREEN_WIDTH - (CHARACTER_WIDTH * 4), height); // set the cursor near the right side of the screen (same height)
+  uint8_t* buffer = display.getBuffer();
+  const int16_t dataPos = SCREEN_WIDTH - (CHARACTER_WIDTH * 4); // near the right side of the screen
+
+  int16_t x = text::drawString(buffer, 0, height, indicator, 1, invert); // draw the indicator on the left-hand side of the screen
+  text::drawString(buffer, x, height, mainMenu[index]->getNameChars(), 1, invert); // and the name right after it
 
-  if (editingMenuItem && index == selectedItem) { // if we are editing it (if it is clicked on)
-    display.print(mainMenu[index]->getTempDataString()); // print temporary data to the screen
+  const char* sub; // what to draw instead of the data, if anything
+  uint32_t data; // the data to draw if there is no substitution
 
-  } else { // otherwise (if it is not clicked on)
-    display.print(mainMenu[index]->getDataString()); // print the menu item data to the screen
+  if (editingMenuItem && index == selectedItem) { // if we are editing it (if it is clicked on), use the temporary data
+    sub = mainMenu[index]->getTempDataSubChars();
+    data = mainMenu[index]->getTempData();
+
+  } else { // otherwise (if it is not clicked on), use the menu item data
+    sub = mainMenu[index]->getDataSubChars();
+    data = mainMenu[index]->getData();
+  }
+
+  if (sub != nullptr) {
+    text::drawString(buffer, dataPos, height, sub, 1, invert);
+
+  } else {
+    text::drawInt(buffer, dataPos, height, static_cast<int32_t>(data), 1, invert);
   }
 }
 
@@ -176,8 +187,6 @@ bool printMenu(uint8_t startHeight, uint8_t lowerBound, uint8_t uperBound) {
 
   uint8_t vertPos = startHeight; // set the vertical cursor position (used later)
 
-  display.setTextSize(1); // set the text size to normal
-
   for (uint16_t i = lowerBound; i <= uperBound; i++) { // for each menu item
     PrintMenuItem(i, vertPos, (i == lowerBound)); // print a menu item
 
@@ -187,57 +196,109 @@ bool printMenu(uint8_t startHeight, uint8_t lowerBound, uint8_t uperBound) {
   return true; // return without errors
 } // printMenu()
 
+void printGraph() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("printGraph() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  tempPlot.update(tempHistory); // only draws what changed sience the last update (usualy nothing, or one column)
+  tempPlot.draw(display.getBuffer());
+}
+
 void printScreensaver() {
   #if DEBUG
   uint8_t core = rp2040.cpuid();
   Serial.printf("printScreenSaver() called from core%u.\n", core); // print a debug message over USB
   #endif
 
-  static uint8_t vert = 0;
-  static uint8_t horiz = 0;
-  static timers::Timer updateTimer;
+  static timers::Timer offTimer;
 
-  if (updateTimer.isSet() && !updateTimer.isDone() && screensaver) return; // don't update the screen if it hasn't been long enough and it was updated since the screensaver started
+  #if SCREENSAVER_PIXEL_SHIFT
+  static timers::Timer shiftTimer;
+  static bool shifted = false; // tracks if the image is currently moved one pixel to the right
+  #endif
 
-  updateTimer.set(SCREENSAVER_SPEED);
-  screensaver = true;
+  if (!screensaver) { // if the screensaver is just starting
+    screensaver = true;
+    offTimer.set(SCREENSAVER_OFF_TIME * 1000);
+
+    #if SCREENSAVER_PIXEL_SHIFT
+    shiftTimer.set(SCREENSAVER_PIXEL_SHIFT_INTERVAL);
+    shifted = false;
+    #endif
+
+    // dim the screen; the last frame stays on it, so nothing else needs to be sent
+    useI2C(8);
+    display.ssd1306_command(SSD1306_SETCONTRAST);
+    display.ssd1306_command(SCREENSAVER_CONTRAST);
+    doneWithI2C();
+    return;
+  }
 
-  if ((horiz + 1) >= SCREEN_WIDTH) { // if we would go off the right edge of the screen
-    horiz = 0; // reset horizontal placement
+  if (offTimer.isDone()) { // if the screen has been dimmed for long enough (only true once)
+    #if SCREENSAVER_PIXEL_SHIFT
+    shiftTimer.stop(); // no point moving an image that can't be seen
+    #endif
 
-    if ((vert + 1) >= SCREEN_HEIGHT) { // if we would go off the bottom edge of the screen
-      vert = 0; // reset vertical position
+    useI2C(8);
+    display.ssd1306_command(SSD1306_DISPLAYOFF); // turn the screen off
+    doneWithI2C();
+    return;
+  }
+
+  #if SCREENSAVER_PIXEL_SHIFT
+  if (shiftTimer.isDone()) { // if it is time to move the image
+    shiftTimer.set(SCREENSAVER_PIXEL_SHIFT_INTERVAL);
+    shiftFrame(!shifted);
+    shifted = !shifted;
+
+    useI2C(8);
+    display.display(); // the only full frame sent while the screensaver is on
+    doneWithI2C();
+  }
+  #endif
+}
+
+void shiftFrame(bool right) {
+  uint8_t* buffer = display.getBuffer();
+
+  for (uint8_t page = 0; page < (SCREEN_HEIGHT / 8); page++) { // for each page (row of 8 pixels) in the buffer
+    uint8_t* row = buffer + (page * SCREEN_WIDTH);
+
+    if (right) {
+      memmove(row + 1, row, SCREEN_WIDTH - 1); // move every column one to the right
+      row[0] = 0; // and blank the one that was uncovered
 
     } else {
-      vert += 1; // move down one pixel
+      memmove(row, row + 1, SCREEN_WIDTH - 1); // move every column one to the left
+      row[SCREEN_WIDTH - 1] = 0; // and blank the one that was uncovered
     }
-
-  } else {
-    horiz += 1;
   }
+}
+
+void wakeScreen() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("wakeScreen() called from core%u.\n", core); // print a debug message over USB
+  #endif
 
-  display.writePixel(static_cast<int16_t>(horiz), static_cast<int16_t>(vert), SSD1306_WHITE); // print a single pixel
+  useI2C(8);
+  display.ssd1306_command(SSD1306_DISPLAYON); // turn the screen back on, in case it was turned off
+  display.dim(false); // go back to the normal contrast
+  doneWithI2C();
 }
 
-void updateScreen() {
+void printMenuPage() {
   #if DEBUG
   uint8_t core = rp2040.cpuid();
-  Serial.printf("updateScreen() called from core%u.\n", core); // print a debug message over USB
+  Serial.printf("printMenuPage() called from core%u.\n", core); // print a debug message over USB
   #endif
 
   uint8_t startPos = 0;  //  where to start printing the main menu
   uint8_t fVisibleMenuItems = VISIBLE_MENU_ITEMS;  //  a variable to store the functionall number of visible menu items (we will set this shortly)
   bool showName;  //  a variable to store if we should display the print name (we will set this shortly)
 
-  display.clearDisplay();  //  clear the dispaly's buffer
-
-  if ((mode == MODE_STANDBY) && ((core1Time - lastUserInput) > (screensaverTime * 1000))) {
-    printScreensaver();
-    goto displayImage;
-  }
-
-  screensaver = false;
-
   if ((mode == MODE_PRINTING || printDone) && (printName[0] != 0)) {  //  if (we are printing OR if the print is done (and the door hasen't been opened)) AND the first character in the print name isn't NULL
     fVisibleMenuItems = VISIBLE_MENU_ITEMS - 1; // set the visible number of menu items to one less than normal
     showName = true; // show the print name
@@ -246,6 +307,11 @@ void updateScreen() {
     showName = false; // don't show the print name
   }
 
+  if ((bottomDisplayMenuItem - topDisplayMenuItem + 1) != fVisibleMenuItems) { // if the print name was just shown or hidden, the window of menu items being viewed changes size (keep its top where it is, unless that runs off the end of the menu)
+    bottomDisplayMenuItem = min(static_cast<uint8_t>(topDisplayMenuItem + fVisibleMenuItems - 1), static_cast<uint8_t>(menuLength - 1));
+    topDisplayMenuItem = bottomDisplayMenuItem - fVisibleMenuItems + 1;
+  }
+
   if (selectedItem < topDisplayMenuItem) { // if the sellected menu Item isn't visible because it is off the top of the screen
     topDisplayMenuItem = selectedItem; // move the window of menu items being viewed up so that it is visible
     bottomDisplayMenuItem = topDisplayMenuItem + fVisibleMenuItems - 1; // find the bottom visible menu item (the one that should be on the bottom)
@@ -274,13 +340,152 @@ void updateScreen() {
   #endif
 
   printMenu(startPos, topDisplayMenuItem, bottomDisplayMenuItem); // display the visible part of the menu, and the print name, if aplicable
+}
+
+#if DISPLAY_STATS
+void printDisplayStats() {
+  char line[32]; // enough for a full line of text, with room to spare
+  uint32_t framePeriod = framePeriodStat.getAvg();
+  uint32_t fps = (framePeriod != 0) ? (1000000 / framePeriod) : 0;
+
+  // average render, display(), and I2C wait times (in tenths of a millisecond), and the frame rate
+  snprintf(line, sizeof(line), "R%lu.%lu D%lu.%lu W%lu.%lu F%lu", renderTimeStat.getAvg() / 1000, (renderTimeStat.getAvg() / 100) % 10,
+    displayTimeStat.getAvg() / 1000, (displayTimeStat.getAvg() / 100) % 10, I2CWaitStat.getAvg() / 1000, (I2CWaitStat.getAvg() / 100) % 10, fps);
+
+  display.fillRect(0, SCREEN_HEIGHT - CHARACTER_HEIGHT, SCREEN_WIDTH, CHARACTER_HEIGHT, SSD1306_WHITE); // clear the bottom line to white, so the stats stand out from the menu
+  text::drawString(display.getBuffer(), 0, SCREEN_HEIGHT - CHARACTER_HEIGHT, line, 1, true);
+}
+
+void reportDisplayStats() {
+  static timers::Timer reportTimer;
+
+  if (reportTimer.isSet() && !reportTimer.isDone()) return; // not time for a report yet
+
+  reportTimer.set(DISPLAY_STATS_INTERVAL);
+
+  uint32_t framePeriod = framePeriodStat.getAvg();
+
+  Serial.printf("Display stats (min / avg / max, us): render %lu / %lu / %lu, display() %lu / %lu / %lu, I2C wait %lu / %lu / %lu, frame %lu / %lu / %lu (%lu.%lu fps).\n",
+    renderTimeStat.getMin(), renderTimeStat.getAvg(), renderTimeStat.getMax(),
+    displayTimeStat.getMin(), displayTimeStat.getAvg(), displayTimeStat.getMax(),
+    I2CWaitStat.getMin(), I2CWaitStat.getAvg(), I2CWaitStat.getMax(),
+    framePeriodStat.getMin(), framePeriod, framePeriodStat.getMax(),
+    (framePeriod != 0) ? (1000000 / framePeriod) : 0, (framePeriod != 0) ? ((10000000 / framePeriod) % 10) : 0); // print the stats over USB
+
+  const stats::RollingStat& mainWait = mainLight.getPowerWaitStat();
+  const stats::RollingStat& pdlWait = printDoneLight.getPowerWaitStat();
+
+  Serial.printf("Light waits for the PSU (min / avg / max, ms): main %lu / %lu / %lu, print done %lu / %lu / %lu.\n",
+    mainWait.getMin(), mainWait.getAvg(), mainWait.getMax(), pdlWait.getMin(), pdlWait.getAvg(), pdlWait.getMax()); // print the stats over USB
+}
+#endif
+
+#if SCREEN_FRAME_DUMP
+void dumpFrame(uint32_t renderTime) {
+  static uint32_t frameNumber = 0;
+
+  const uint8_t* buffer = display.getBuffer();
+
+  Serial.printf("P4\n# frame %lu, rendered in %lu us\n%u %u\n", frameNumber++, renderTime, SCREEN_WIDTH, SCREEN_HEIGHT); // the PBM header
+
+  for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) { // for each row of pixels
+    uint8_t row[SCREEN_WIDTH / 8] = {0}; // PBM packs each row left to right, most significant bit first
+
+    for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
+      if (!((buffer[((y >> 3) * SCREEN_WIDTH) + x] >> (y & 7)) & 1)) { // unlit pixels are black (1 in PBM), so the image looks like the screen
+        row[x >> 3] |= 0x80 >> (x & 7);
+      }
+    }
+
+    Serial.write(row, sizeof(row));
+  }
+}
+#endif
+
+void updateScreen() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("updateScreen() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  #if COUNT_HEAP_ALLOCATIONS
+  uint32_t startAllocations = heapAllocations; // how many allocations had been made before this frame
+  int startHeap = rp2040.getUsedHeap(); // and how much of the heap was in use
+  #endif
+
+  // record the temperatures for the graph, even if it isn't being shown
+  tempHistory.setWindow(graphWindow);
+  tempHistory.tick(core1Time, inTemp, outTemp, heaterTemp, globalSetTemp);
+
+  if ((mode == MODE_STANDBY) && ((core1Time - lastUserInput) > (screensaverTime * 1000))) {
+    printScreensaver(); // the screensaver handles the screen itself, and sends as little as possible
+    return;
+  }
+
+  if (screensaver) { // if the screensaver was on last loop
+    wakeScreen();
+    screensaver = false;
+  }
+
+  #if SCREEN_FRAME_DUMP || DISPLAY_STATS
+  uint32_t renderStart = micros();
+  #endif
+
+  #if DISPLAY_STATS
+  static uint32_t lastRenderStart = renderStart;
+  if (renderStart != lastRenderStart) framePeriodStat.add(renderStart - lastRenderStart);
+  lastRenderStart = renderStart;
+  #endif
+
+  display.clearDisplay();  //  clear the dispaly's buffer
+
+  if (showGraph) { // if the graph page is being shown instead of the menu
+    printHeader();
+    printGraph();
+
+    dispLastLoop = false; // the print name wasn't displayed (but shouldn't be cleared either)
+
+  } else {
+    printMenuPage();
+  }
+
+  #if SCREEN_FRAME_DUMP || DISPLAY_STATS
+  uint32_t renderTime = micros() - renderStart;
+  #endif
+
+  #if DISPLAY_STATS
+  renderTimeStat.add(renderTime);
+  printDisplayStats();
+
+  uint32_t waitStart = micros();
+  #endif
 
-displayImage:
   useI2C(8);
 
+  #if DISPLAY_STATS
+  uint32_t displayStart = micros();
+  I2CWaitStat.add(displayStart - waitStart);
+  #endif
+
   display.display(); // write everything to the display
 
+  #if DISPLAY_STATS
+  displayTimeStat.add(micros() - displayStart);
+  #endif
+
   doneWithI2C();
+
+  #if DISPLAY_STATS
+  reportDisplayStats();
+  #endif
+
+  #if SCREEN_FRAME_DUMP
+  dumpFrame(renderTime); // send the frame over USB
+  #endif
+
+  #if COUNT_HEAP_ALLOCATIONS
+  Serial.printf("Frame: %lu allocations, heap %+d bytes.\n", heapAllocations - startAllocations, rp2040.getUsedHeap() - startHeap); // print how much the frame allocated over USB
+  #endif
 }
 
 // the function called when the "sell." menu button is pressed
@@ -290,8 +495,14 @@ void sell_switch_Pressed() {
   Serial.printf("sell_switch_Pressed() called from core%u.\n", core); // print a debug message over USB
   #endif
 
+  if (showGraph) { // if the graph is being shown, go back to the menu
+    showGraph = false;
+    return;
+  }
+
   if (editingMenuItem) { // if we are currently editing a item on the menu (before the button was pressed)
     mainMenu[selectedItem]->setData(mainMenu[selectedItem]->getTempData()); // set the menu item data to it's temporary data
+    fixFanCurve(); // in case a curve point (or the max RPM) was changed so the curve would stall the fan
 
     editingMenuItem = false; // we are no longer editing the menu item
 
@@ -308,6 +519,8 @@ void up_switch_Pressed() {
   Serial.printf("up_switch_Pressed() called from core%u.\n", core); // print a debug message over USB
   #endif
 
+  if (showGraph) return; // the menu isn't being shown
+
   if (editingMenuItem) { // if we are editing the data pointed to by an item
     mainMenu[selectedItem]->incrementTempData(); // add one to the temporary data
 
@@ -325,6 +538,8 @@ void down_switch_Pressed() {
   Serial.printf("down_switch_Pressed() called from core%u.\n", core); // print a debug message over USB
   #endif
 
+  if (showGraph) return; // the menu isn't being shown
+
   if (editingMenuItem) { // if we are editing the data pointed to by an item
     mainMenu[selectedItem]->decrementTempData(); // subtract one form the temporary data
 
@@ -29,6 +29,7 @@
 #include "vars.hpp"
 #include "customLibs.hpp"
 #include "otherFuncs.hpp"
+#include "textRenderer.hpp"
 
 /**
 * @brief clears the print name variable
@@ -62,10 +63,51 @@ void PrintMenuItem(uint8_t index, uint8_t height, bool topItem);
 bool printMenu(uint8_t startHeight, uint8_t lowerBound, uint8_t uperBound);
 
 /**
-* @brief prints a screensaver on the entire screen
+* @brief the lower-level function that prints the temperature graph below the header
+*/
+void printGraph();
+
+/**
+* @brief handles the screensaver: dims the screen, then turns it off after SCREENSAVER_OFF_TIME. Sends nothing over I2C in between (unless pixel shifting is enabled)
 */
 void printScreensaver();
 
+/**
+* @brief moves the whole display buffer one pixel to the right or left, blanking the uncovered column
+* @param right true to move the image right, false to move it left
+*/
+void shiftFrame(bool right);
+
+/**
+* @brief turns the screen back on and restores its normal contrast after the screensaver
+*/
+void wakeScreen();
+
+/**
+* @brief draws the header, the print name (if aplicable), and the visible part of the menu
+*/
+void printMenuPage();
+
+#if DISPLAY_STATS
+/**
+* @brief draws the average render, display(), and I2C wait times (in ms) and the frame rate over the bottom line of the screen
+*/
+void printDisplayStats();
+
+/**
+* @brief sends the min / avg / max display stats over USB, at most once every DISPLAY_STATS_INTERVAL ms
+*/
+void reportDisplayStats();
+#endif
+
+#if SCREEN_FRAME_DUMP
+/**
+* @brief sends the frame buffer over USB as a PBM image, with the render time in a comment
+* @param renderTime the time it took to draw the frame, in microseconds
+*/
+void dumpFrame(uint32_t renderTime);
+#endif
+
 /**
 * @brief the higher-level function called whenever the screen needs to be updated
 */
@@ -44,25 +44,26 @@ void standard() {
   }
 
   if (core1WatchdogTimer.isDone()) setError(11, 1, false); // set mode to error if the core 1 (software) watchdog timer ran out
-  if (controlMode == CONTROL_MODE_TEMP && oldControlMode == CONTROL_MODE_MANUAL) globalSetTemp = DEFAULT_SET_TEMP;
+  if (controlMode != CONTROL_MODE_MANUAL && oldControlMode == CONTROL_MODE_MANUAL) globalSetTemp = DEFAULT_SET_TEMP;
 
   // todo: fix
   mainMenu[1]->setIsEditable(!(controlMode == CONTROL_MODE_MANUAL)); // SCARY! BAD! FIND A BETTER WAY TO DO THIS! - self
 
   blinkLED(); // handle blinking the LED to indicate status
-  updateServos(); // handle servo movement
   updateFan(); // handle fan speed
+  updateVent(); // handle the vent flaps (after the fan, so they open or close the same loop the fan asks)
 
   // update lights
-  printDoneLight.setSpeed(pdl_DimingTime);
-  mainLight.setSpeed(dimingTime);
   printDoneLight.setState(printDone); // set print done light to correct state
+  printDoneLight.setPattern(printDonePattern()); // and show a pattern if there is one for the current state
   mainLight.setState(lightSetState); // set lights to correct state
 
   if (changeLights) { // if the light's state needs to change:
     mainLight.changeState();
   }
 
+  stripLight.setState(mainLight.getState()); // the light strip follows the main lights (set its level to 0 to keep it off)
+
   #if SERIAL_CONTROL
   serialReceiveEvent(); // check for any commands sent via USB
   #endif
@@ -91,12 +92,9 @@ const void standby() {
 
   //  turn off the fan and heaters:
   setHeaters(false, false); // turn off both heaters
-  setFan(fanOffVal); // turn off the fan
-
-  //  move servos to home position:
-  setServos(servo1Closed, servo2Closed); // move servos 1 and 2 to home
+  setAirflow(fanOffVal); // turn off the fan | updateFan() closes the vent once the fan has stopped
 
-  setPSU(mainLight.needsPower() || printDoneLight.needsPower()); // turn on the PSU if the lights are on OR if the PSU shouldn't be turned off OR if the print is done (the print done light is on)
+  setPSU(lightManager.needsPower()); // turn on the PSU if any of the lights are on (or changing)
 
   #if DEBUG
   Serial.printf("Did standby().\n"); // print a debug message over USB
@@ -112,11 +110,11 @@ const void cooldown() {
 
   if ((inTemp - cooldownDif) > outTemp) { // if the temp inside is much greater than the temp outside:
     // ensure the fan and the lights have power if they need it:
-    setPSU(!doorOpen || mainLight.needsPower() || printDoneLight.needsPower()); // if the door is closed OR if the lights are on OR the PSU shouldn't be turned off OR if the print is done (print done light on), turn on the PSU. otherwise, turn it off
+    setPSU(!doorOpen || lightManager.needsPower()); // if the door is closed OR if any of the lights are on (or changing), turn on the PSU. otherwise, turn it off
 
     // set the heaters and fan:
     setHeaters(false, false); // turn off heaters
-    setFan(fanOnVal); // turn on fan if door closed
+    setAirflow(fanOnVal); // turn on fan if door closed
 
   } else {
     mode = MODE_STANDBY; // set the mode to standby
@@ -140,10 +138,22 @@ const void printing() {
     case CONTROL_MODE_MANUAL:
       heatingLogic_manual();
       break; // exit the switch... case statement
+
+    case CONTROL_MODE_PID:
+      heatingLogic_pid();
+      break; // exit the switch... case statement
+
+    case CONTROL_MODE_AUTOTUNE:
+      heatingLogic_autotune();
+      break; // exit the switch... case statement
+
+    case CONTROL_MODE_CASCADE:
+      heatingLogic_cascade();
+      break; // exit the switch... case statement
     
     default:
       setHeaters(false, false); // turn off heaters
-      setFan(fanOffVal); // turn off fan
+      setAirflow(fanOffVal); // turn off fan
       break;  // exit the switch... case statement
   }
 
@@ -190,6 +200,7 @@ const void error() {
   digitalWrite(ERROR_LIGHT_PIN, ERROR_LIGHT_ON); // turn on the error light
   digitalWrite(LED_PIN, LOW); // turn off built-in LED
 
+  cancel_repeating_timer(&heaterTimer); // so heaterTick() can't turn the heaters back on
   gpioDisable(); // set pins do a disconnected, high-impedance state (excludes the error light and built-in LED)
 
   if (Serial) Serial.printf("The enclosure has entered safe mode.\n"); // print a debug message over USB if a computer is connected
@@ -26,6 +26,14 @@
 #include "vars.hpp"
 #include <cstdint>
 
+#if COUNT_HEAP_ALLOCATIONS
+// count every allocation made with new (the core already wraps malloc() itself, so plain malloc() calls can't be counted here)
+void* operator new(size_t size) {
+  heapAllocations++;
+  return malloc(size);
+}
+#endif
+
 void setError(uint8_t origin, uint32_t info, bool recoverable) {
   mode = MODE_ERROR; // mode to error
   errorOrigin = origin; // record the origin of the error
@@ -70,6 +78,16 @@ void blinkLED() {
   }
 }
 
+const lights::Pattern* printDonePattern() {
+  if (!pdl_Patterns) return nullptr; // patterns are turned off
+
+  if (needsAttention) return &attentionPattern;
+  if (mode == MODE_COOLDOWN) return &coolingPattern; // shown over the done pattern, so that done means the print is ready to take out
+  if (printDone) return &donePattern;
+
+  return nullptr;
+}
+
 void blinkErrorCode(uint8_t code) {
   std::vector<uint8_t> base4Digits = base2ToBase4(code); // convert to base 4 | base4Digits[0] will be the least significant digit
 
@@ -267,58 +285,85 @@ bool setPSU(bool state) {
   }
 }
 
-void updateServos() {
+void updateVent() {
   #if DEBUG
   uint8_t core = rp2040.cpuid();
-  Serial.printf("updateServos() called from core%u.\n", core); // print a debug message over USB
+  Serial.printf("updateVent() called from core%u.\n", core); // print a debug message over USB
   #endif
 
-  static uint8_t servo1Pos = 0;
-  static uint8_t servo2Pos = 0;
+  static timers::Timer settleTimer; // set once the trajectories have ended, while the servos catch up
 
-  if (servo1Pos != servo1SetPos) {
-    if (servo1Pos > servo1SetPos) {
-      for (int16_t i = servo1Pos; i >= servo1SetPos; i--) {
-        servo1.write(i);
-        delay(servo1Speed);
-      }
-      
-    } else {
-      for (int16_t i = servo1Pos; i <= servo1SetPos; i++) {
-        servo1.write(i);
-        delay(servo1Speed);
-      }
-    }
+  bool open = ventOpenRequested;
+  uint8_t s1_Target = open ? servo1Open : servo1Closed;
+  uint8_t s2_Target = open ? servo2Open : servo2Closed;
 
-    servo1Pos = servo1SetPos;
+  if (servo1Trajectory.getTarget() != s1_Target || servo2Trajectory.getTarget() != s2_Target) { // if the vent was opened or closed (or its open / closed positions were changed)
+    moveServos(s1_Target, s2_Target);
+    settleTimer.stop();
+    ventState = open ? VENT_OPENING : VENT_CLOSING;
   }
 
-  if (servo2Pos != servo2SetPos) {
-    if (servo2Pos > servo2SetPos) {
-      for (int16_t i = servo2Pos; i >= servo2SetPos; i--) {
-        servo2.write(i);
-        delay(servo2Speed);
-      }
+  if (ventState != VENT_OPENING && ventState != VENT_CLOSING) return; // the flaps aren't moving
 
-    } else {
-      for (int16_t i = servo2Pos; i <= servo2SetPos; i++) {
-        servo2.write(i);
-        delay(servo2Speed);
-      }
-    }
+  if (!settleTimer.isSet()) {
+    uint32_t now = millis();
+
+    if (servo1Trajectory.isDone(now) && servo2Trajectory.isDone(now)) settleTimer.set(SERVO_SETTLE_TIME);
+
+  } else if (settleTimer.isDone()) { // the flaps should be there by now
+    settleTimer.stop();
+
+    uint32_t interrupts = save_and_disable_interrupts(); // so servoTick() doesn't write to a half-detached servo
+    servo1.detach(); // the flaps hold themselves; this stops the servos jittering (and drawing power)
+    servo2.detach();
+    restore_interrupts(interrupts);
 
-    servo2Pos = servo2SetPos;
+    ventState = (ventState == VENT_OPENING) ? VENT_OPEN : VENT_CLOSED;
+
+    #if DEBUG
+    Serial.printf("updateVent() detached the servos; the vent is %s.\n", (ventState == VENT_OPEN) ? "open" : "closed"); // print a debug message over USB
+    #endif
   }
 }
 
-void setServos(uint8_t s1_Pos, uint8_t s2_Pos) {
+void setVent(bool open) {
   #if DEBUG
   uint8_t core = rp2040.cpuid();
-  Serial.printf("setServos(%u, %u) called from core%u.\n", s1_Pos, s2_Pos, core); // print a debug message over USB
+  Serial.printf("setVent(%d) called from core%u.\n", open, core); // print a debug message over USB
   #endif
-  
-  servo1SetPos = s1_Pos;
-  servo2SetPos = s2_Pos;
+
+  ventOpenRequested = open;
+}
+
+bool ventIsOpen() {
+  return ventState == VENT_OPEN;
+}
+
+void moveServos(uint8_t s1_Pos, uint8_t s2_Pos) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("moveServos(%u, %u) called from core%u.\n", s1_Pos, s2_Pos, core); // print a debug message over USB
+  #endif
+
+  uint32_t now = millis();
+
+  // the moves themselves are done by servoTick() | interrupts are off while a servo is attached or a trajectory is changed so it never sees half of one
+  uint32_t interrupts = save_and_disable_interrupts();
+
+  if (!servo1.attached()) {
+    servo1.write(servo1Trajectory.getPosition(now)); // so it starts where it was left, not at its center
+    servo1.attach(SERVO_1_PIN);
+  }
+
+  if (!servo2.attached()) {
+    servo2.write(servo2Trajectory.getPosition(now));
+    servo2.attach(SERVO_2_PIN);
+  }
+
+  if (servo1Trajectory.getTarget() != s1_Pos) servo1Trajectory.start(s1_Pos, now, servo1Speed, SERVO_ACCELERATION);
+  if (servo2Trajectory.getTarget() != s2_Pos) servo2Trajectory.start(s2_Pos, now, servo2Speed, SERVO_ACCELERATION);
+
+  restore_interrupts(interrupts);
 }
 
 void updateFan() {
@@ -328,45 +373,162 @@ void updateFan() {
   #endif
 
   static timers::Timer kickstartTimer;
+  static timers::Timer stallTimer; // set while the fan is stalled
+  static timers::Timer spinDownTimer; // set while the fan is spinning down, before the vent closes
   static uint8_t oldTargetFanSpeed = 0;
   static uint8_t oldMaxFanSpeed = 255;
+  static bool oldClosedLoop = false;
+  static uint8_t stallKickstarts = 0; // how many times in a row the fan has been kickstarted because it stalled
+  static bool startPending = false; // true from a kickstart until the fan is seen spinning on its own
+  static bool spunUp = false; // true if the fan has been seen spinning since the last kickstart
+  static uint32_t kickstartEnd = 0; // when the last kickstart ended (ms)
+  static uint16_t runningDuty = 0; // the last duty cycle set after a kickstart
+  static bool heldAtMinDuty = false; // true if the fan has been held at the learned minimum duty since it was started (without stalling)
+  static uint8_t cleanRuns = 0; // how many runs in a row have held the fan at the learned minimum duty without it stalling
+  static bool tachWorking = false; // true once a reading has shown the fan turning, so closed loop can trust fanRPM
+
+  #if FAN_HAS_TACH
+  bool newReading = fanTach.update();
+
+  if (newReading) { // if there is a new RPM reading
+    fanRPM = fanTach.getRPM();
+
+    if (fanRPM >= FAN_STALL_RPM) {
+      spunUp = true;
+      tachWorking = true;
+    }
+
+    // the start worked if the fan is spinning over a whole reading taken after the kickstart, so try a shorter one next time
+    if (startPending && oldTargetFanSpeed != 0 && (millis() - kickstartEnd) >= FAN_TACH_INTERVAL && fanRPM >= FAN_STALL_RPM) {
+      startPending = false;
+
+      if (fanLearning) {
+        uint16_t kickstartTime = fanKickstartTime;
+        fanKickstartTime = max(static_cast<uint16_t>(kickstartTime - (kickstartTime / FAN_KICKSTART_SHRINK)), static_cast<uint16_t>(FAN_KICKSTART_MIN_TIME));
+      }
+    }
+
+    if (oldTargetFanSpeed != 0 && !doorOpen && fanRPM < FAN_STALL_RPM) { // if the fan should be spinning (and has been kickstarted), but isn't
+      if (!stallTimer.isSet()) stallTimer.set(FAN_STALL_TIME);
+
+    } else {
+      stallTimer.stop();
+
+      if (fanRPM >= FAN_STALL_RPM) stallKickstarts = 0; // it's spinning
+    }
+  }
+
+  if (stallTimer.isDone()) { // if the fan has been stalled for too long
+    if (stallKickstarts >= FAN_STALL_KICKSTARTS) { // kickstarting it didn't work
+      setError(15, fanRPM, true);
+      return;
+    }
+
+    if (fanLearning) {
+      if (startPending && !spunUp) { // it never got going, so the kickstart was too short
+        uint16_t kickstartTime = fanKickstartTime;
+        fanKickstartTime = min(static_cast<uint16_t>(kickstartTime + (kickstartTime / 2) + FAN_KICKSTART_MIN_TIME), static_cast<uint16_t>(FAN_KICKSTART_MAX_TIME));
+
+      } else { // it was spinning, but slowed down and stopped, so the duty cycle was too low
+        uint8_t stallDuty = runningDuty >> 8;
+        fanMinDuty = max(fanMinDuty.load(), static_cast<uint8_t>(min(stallDuty + FAN_MIN_DUTY_STEP, 255)));
+      }
+    }
+
+    stallKickstarts++;
+    heldAtMinDuty = false;
+    cleanRuns = 0;
+    oldTargetFanSpeed = 0; // so that the fan is kickstarted again below
+    fanController.reset(); // the integral wound up while the fan was stalled
 
-  if (targetFanSpeed == oldTargetFanSpeed && maxFanSpeed == oldMaxFanSpeed && !doorOpen) {
+    #if DEBUG
+    Serial.printf("updateFan() found the fan stalled at %u RPM; kickstarting it (attempt %u).\n", fanRPM.load(), stallKickstarts); // print a debug message over USB
+    #endif
+  }
+  #else
+  bool newReading = false; // there is no tachometer, so no readings (and no stall detection)
+  #endif
+
+  if (spinDownTimer.isSet() && ((FAN_HAS_TACH && fanRPM < FAN_STALL_RPM) || spinDownTimer.isDone())) { // the fan has stopped (or had long enough to)
+    spinDownTimer.stop();
+    setVent(false); // close the vent
+  }
+
+  if (targetFanSpeed == oldTargetFanSpeed && maxFanSpeed == oldMaxFanSpeed && fanClosedLoop == oldClosedLoop && !doorOpen && !(fanClosedLoop && newReading)) { // the closed loop needs to run with every new reading
     #if DEBUG
     Serial.printf("updateFan() returning because nothing has changed.\n"); // print a debug message over USB
     #endif
     return;
   }
 
-  if (targetFanSpeed == 0 || doorOpen) {
-    analogWrite(FAN_PIN, !FAN_ON * 255); // turn fan off
-    setServos(servo1Closed, servo2Closed); // close servos
+  uint8_t currentMaxFanSpeed = maxFanSpeed.load();
+  uint8_t minDuty = fanMinDuty;
+  uint16_t maxRPM = fanMaxRPM;
+
+  // an airflow is held in closed loop only once the tachometer has shown the fan turning (until then it is run as a duty cycle) | a target too slow to keep the fan turning is raised to FAN_MIN_RPM (closed loop, so the fan isn't taken for stalled) or the learned minimum duty (open loop) | the max fan speed is applied last, so if it is below that the fan is off
+  fans::SpeedPlan plan = fans::planSpeed(targetFanSpeed, currentMaxFanSpeed, fanClosedLoop, FAN_HAS_TACH && tachWorking, maxRPM, FAN_MIN_RPM, minDuty);
+
+  if (plan.speed == 0 || doorOpen) {
+    fanOutput.write(0); // turn fan off
+
+    if (oldTargetFanSpeed != 0) { // a run just ended
+      // it ran at the minimum duty without stalling, so (after a few runs) try a lower one, like the kickstart time | a stall raises it again
+      if (FAN_HAS_TACH && heldAtMinDuty && fanLearning && (++cleanRuns >= FAN_MIN_DUTY_DECAY_RUNS)) {
+        fanMinDuty = max(static_cast<int16_t>(fanMinDuty.load() - FAN_MIN_DUTY_DECAY_STEP), static_cast<int16_t>(0));
+        cleanRuns = 0;
+      }
+
+      heldAtMinDuty = false;
+    }
+
+    if (ventOpenRequested && !spinDownTimer.isSet()) spinDownTimer.set(FAN_SPIN_DOWN_TIME); // the vent is closed (above) once the fan has spun down, so the flaps don't close on a fan still blowing against them
     oldTargetFanSpeed = 0; // settign to zero directly instead of `targetFanSpeed` for speed reasons
     #if DEBUG
-    Serial.printf("updateFan() returning after turning off fan because fan is being turned off, or door is open.\n"); // print a debug message over USB
+    Serial.printf("updateFan() returning after turning off fan because fan is being turned off (or capped below its minimum), or door is open.\n"); // print a debug message over USB
     #endif
     return;
   }
   
+  spinDownTimer.stop(); // the fan is wanted again, so the vent stays open
+  setVent(true); // open the vent
+
   if (oldTargetFanSpeed == 0 && !kickstartTimer.isSet()) {
-    analogWrite(FAN_PIN, FAN_ON * 255); // turn on the fan at 100%
-    setServos(servo1Open, servo2Open); // open servos
+    if (!ventIsOpen()) { // wait for the flaps to open before starting the fan
+      #if DEBUG
+      Serial.printf("updateFan() returning because the vent isn't open yet.\n"); // print a debug message over USB
+      #endif
+      return;
+    }
+
+    fanOutput.write(UINT16_MAX); // turn on the fan at 100%
     kickstartTimer.set(fanKickstartTime);
+    startPending = true;
+    spunUp = false;
     #if DEBUG
     Serial.printf("updateFan() returning after kickstarting fan.\n"); // print a debug message over USB
     #endif
 
   } else if (kickstartTimer.isDone() || !kickstartTimer.isSet()) {
-    uint8_t currentMaxFanSpeed = maxFanSpeed.load();
-    #if FAN_ON == HIGH
-    analogWrite(FAN_PIN, min(targetFanSpeed, currentMaxFanSpeed));
-    #else
-    analogWrite(FAN_PIN, ~static_cast<uint8_t>(min(targetFanSpeed, currentMaxFanSpeed)));
-    #endif
+    uint16_t dutyCycle;
+
+    if (oldTargetFanSpeed == 0) kickstartEnd = millis(); // the kickstart just ended
+
+    if (plan.closedLoop) { // find the duty cycle that holds the fan at the target speed
+      dutyCycle = fanController.update(plan.speed, fanRPM, maxRPM, minDuty);
+
+    } else {
+      dutyCycle = plan.speed * 257; // from 0 - 255 to 0 - 65535
+    }
+
+    if (minDuty != 0 && dutyCycle <= (minDuty * 257)) heldAtMinDuty = true;
+
+    fanOutput.write(dutyCycle);
+    runningDuty = dutyCycle;
     oldTargetFanSpeed = targetFanSpeed;
     oldMaxFanSpeed = currentMaxFanSpeed;
+    oldClosedLoop = fanClosedLoop;
     #if DEBUG
-    Serial.printf("updateFan() returning after setting the fan with a target speed of %u and a max speed of %u.\n", targetFanSpeed, currentMaxFanSpeed); // print a debug message over USB
+    Serial.printf("updateFan() returning after setting the fan to a duty cycle of %u (target %u, max %u, %s loop).\n", dutyCycle, targetFanSpeed, currentMaxFanSpeed, plan.closedLoop ? "closed" : "open"); // print a debug message over USB
     #endif
   }
 }
@@ -378,6 +540,47 @@ void setFan(uint8_t dutyCycle) {
   #endif
 
   targetFanSpeed = dutyCycle;
+  fanClosedLoop = false;
+}
+
+void setAirflow(uint8_t airflow) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("setAirflow(%u) called from core%u.\n", airflow, core); // print a debug message over USB
+  #endif
+
+  targetFanSpeed = airflow;
+  fanClosedLoop = true;
+}
+
+uint8_t fanCurveAirflow(int16_t error) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("fanCurveAirflow(%d) called from core%u.\n", error, core); // print a debug message over USB
+  #endif
+
+  fans::CurvePoint points[FAN_CURVE_MAX_POINTS]; // a snapshot of the curve, so it can't change part way through
+  uint8_t count = min(fanCurvePoints.load(), static_cast<uint8_t>(FAN_CURVE_MAX_POINTS));
+
+  for (uint8_t i = 0; i < count; i++) {
+    points[i] = {fanCurveErrors[i], fanCurveAirflows[i]};
+  }
+
+  return fans::evaluateCurve(points, count, error, TEMP_FRACTION_BITS);
+}
+
+void fixFanCurve() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("fixFanCurve() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  uint8_t lowest = fans::lowestAirflow(FAN_MIN_RPM, fanMaxRPM);
+
+  for (uint8_t i = 0; i < FAN_CURVE_MAX_POINTS; i++) {
+    uint8_t airflow = fanCurveAirflows[i];
+    if (airflow != 0 && airflow < lowest) fanCurveAirflows[i] = lowest;
+  }
 }
 
 void setHeaters(bool h1_On, bool h2_On) {
@@ -386,32 +589,56 @@ void setHeaters(bool h1_On, bool h2_On) {
   Serial.printf("setHeaters(%d, %d) called from core%u.\n", h1_On, h2_On, core); // print a debug message over USB
   #endif
 
-  static bool h1_isOn = false;
-  static bool h2_isOn = false;
+  setHeaterDemand(h1_On * HEATER_DEMAND_MAX, h2_On * HEATER_DEMAND_MAX);
+}
+
+void setHeaterDemand(uint16_t h1_Demand, uint16_t h2_Demand) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("setHeaterDemand(%u, %u) called from core%u.\n", h1_Demand, h2_Demand, core); // print a debug message over USB
+  #endif
 
   if (doorOpen) {
     #if DEBUG
-    Serial.printf("setHeaters() will turn everything off; the door is open.\n"); // print a debug message over USB
+    Serial.printf("setHeaterDemand() will turn everything off; the door is open.\n"); // print a debug message over USB
     #endif
 
-    h1_On = false;
-    h2_On = false;
-
-  } else {
-    #if DEBUG
-    Serial.printf("setHeaters() will do as requested; the door is closed.\n"); // print a debug message over USB
-    #endif
+    heater1Output.stop(); // off now, not after the minimum on time
+    heater2Output.stop();
+    return;
   }
 
-  digitalWrite(HEATER_1_PIN, !h1_On); // set the value of heater1
-  digitalWrite(HEATER_2_PIN, !h2_On); // set the value of heater2
+  heater1Output.setDemand(h1_Demand);
+  heater2Output.setDemand(h2_Demand);
+}
+
+void setHeat(uint16_t demand) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("setHeat(%u) called from core%u.\n", demand, core); // print a debug message over USB
+  #endif
 
-  if ((h1_On != h1_isOn) || (h2_On != h2_isOn)) { // if we are turning the heaters off or on (if the state of the heaters is changing)
-    mainLight.blip(25000); // bypass a hardware issue? This fixed a bug, so don't change
+  static bool heater2Leads = false;
+
+  if (!heaterStaging) { // heater 2 isn't used
+    setHeaterDemand(demand, 0);
+    return;
   }
 
-  h1_isOn = h1_On;
-  h2_isOn = h2_On;
+  if (oldMode != MODE_PRINTING) heaterStager.reset(); // don't carry anything over from the last print
+
+  int16_t error = (static_cast<int16_t>(globalSetTemp) << TEMP_FRACTION_BITS) - inTempFine;
+  bool staged = heaterStager.update(demand, error, inTempFine, millis());
+
+  // swap which heater leads once the leader has been on HEATER_ROTATE_TIME longer than the other | compared by difference, so the times wrapping around doesn't matter
+  int32_t leadOverLag = static_cast<int32_t>(heater1Output.getTotalOnTime() - heater2Output.getTotalOnTime());
+  if (heater2Leads) leadOverLag = -leadOverLag;
+  if (leadOverLag > HEATER_ROTATE_TIME) heater2Leads = !heater2Leads;
+
+  uint16_t lagDemand = staged ? demand : 0;
+
+  if (heater2Leads) setHeaterDemand(lagDemand, demand);
+  else setHeaterDemand(demand, lagDemand);
 }
 
 bool startSerial() {
@@ -439,8 +666,8 @@ uint32_t readTempSensor(Adafruit_MCP9808* sensor, uint8_t sensorID, uint8_t SCAL
 }
 
 bool getTemp() {
-  constexpr uint8_t SCALE_MULT = 8; // used for multiplication
-  constexpr uint8_t SCALE_SHIFT = 3; // used for bitshifting
+  constexpr uint8_t SCALE_MULT = 1 << TEMP_FRACTION_BITS; // used for multiplication
+  constexpr uint8_t SCALE_SHIFT = TEMP_FRACTION_BITS; // used for bitshifting
   constexpr uint8_t SCALE_OFFSET = SCALE_MULT / 2;
   constexpr uint16_t scaled_maxHeaterTemp = MAX_HEATER_TEMP * SCALE_MULT;
   constexpr uint16_t scaled_maxInOutTemp = MAX_IN_OUT_TEMP * SCALE_MULT;
@@ -462,6 +689,7 @@ bool getTemp() {
   }
 
   lastReadTime = millis(); // update the time
+  tempReadTime = lastReadTime;
 
   #if DEBUG
   Serial.printf("It has been long enough between temp readings, reading the temp...\n");
@@ -483,8 +711,10 @@ bool getTemp() {
   }
 
   // logic is: find average reading, add 0.5 (SCALE_OFFSET) because later bitshifting wil truncate things, and then convert back to regular integers from fixed-point by bitshifting
-  heaterTemp = ((tempHeaterTemp / sensorReads) + SCALE_OFFSET) >> SCALE_SHIFT;  //  set the temperature to the temporary variable devided by the number of times the temperature was read
-  inTemp = ((tempInTemp / sensorReads) + SCALE_OFFSET) >> SCALE_SHIFT;  //  set the temperature to the temporary variable devided by the number of times the temperature was read
+  heaterTempFine = tempHeaterTemp / sensorReads; // keep the fractional bits for the cascade controller
+  heaterTemp = (heaterTempFine + SCALE_OFFSET) >> SCALE_SHIFT;  //  set the temperature to the temporary variable devided by the number of times the temperature was read
+  inTempFine = tempInTemp / sensorReads; // keep the fractional bits for the fan curve
+  inTemp = (inTempFine + SCALE_OFFSET) >> SCALE_SHIFT;  //  set the temperature to the temporary variable devided by the number of times the temperature was read
   outTemp = ((tempOutTemp / sensorReads) + SCALE_OFFSET) >> SCALE_SHIFT;  //  set the temperature to the temporary variable devided by the number of times the temperature was read
 
   #if DEBUG
@@ -494,6 +724,16 @@ bool getTemp() {
   return true;
 } // bool getTemp()
 
+void readHeaterTemp() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("readHeaterTemp() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  heaterTempFine = readTempSensor(&heaterTempSensor, 1, 1 << TEMP_FRACTION_BITS, TEMP_FRACTION_BITS, MAX_HEATER_TEMP << TEMP_FRACTION_BITS); // sets the error (and gives 0) if it is too hot
+  heaterTemp = (heaterTempFine + ((1 << TEMP_FRACTION_BITS) / 2)) >> TEMP_FRACTION_BITS;
+}
+
 void lightswitchPressed() {
   #if DEBUG
   uint8_t core = rp2040.cpuid();
@@ -524,6 +764,7 @@ void doorOpening() {
 
   doorOpen = true; // remember the door is open
   printDone = false; // the print might have been removed; remember that the print is not done
+  needsAttention = false; // someone has come to the printer
 
   if (lights_On_On_Door_Open && !mainLight.getState()) { // if the lights should change on door open
     turnLightOff = true;
@@ -539,10 +780,12 @@ void doorOpening() {
     for (uint16_t i = 0; i < 256; i++) { // go through all the characters in the print name
       printName[i] = 0; // and set them to NULL
     } // for (uint8_t i = 0; i < 256; i++)
+
+    printNameChanged = true;
   } // if (mode != MODE_PRINTING)
 
   setHeaters(false, false); // turn off heaters
-  setFan(!FAN_ON * 255); // turn off fan
+  setFan(0); // turn off fan
 
   #if DEBUG
   Serial.printf("Door open.\n"); // print a debug message over the sellected debug port
@@ -628,6 +871,8 @@ void gpioDisable() {
   // set nearely all pins (all used except for error light and built-in LED) to a disconnected, high-impedance state
   gpio_set_function(FAN_PIN, GPIO_FUNC_NULL); // fan
   gpio_disable_pulls(FAN_PIN); // fan
+  gpio_set_function(FAN_TACH_PIN, GPIO_FUNC_NULL); // fan tachometer
+  gpio_disable_pulls(FAN_TACH_PIN); // fan tachometer
   gpio_set_function(PSU_ON_PIN, GPIO_FUNC_NULL); // power supply
   gpio_disable_pulls(PSU_ON_PIN); // power supply
   gpio_set_function(HEATER_1_PIN, GPIO_FUNC_NULL); // heater1
@@ -650,6 +895,8 @@ void gpioDisable() {
   gpio_disable_pulls(LIGHTS_PIN); // lights
   gpio_set_function(PRINT_DONE_LIGHT_PIN, GPIO_FUNC_NULL); // print done light
   gpio_disable_pulls(PRINT_DONE_LIGHT_PIN); // print done light
+  gpio_set_function(LIGHT_STRIP_PIN, GPIO_FUNC_NULL); // light strip
+  gpio_disable_pulls(LIGHT_STRIP_PIN); // light strip
   gpio_set_function(POWER_OK_PIN, GPIO_FUNC_NULL); // power OK
   gpio_disable_pulls(POWER_OK_PIN); // power OK
   gpio_set_function(DOWN_SWITCH_PIN, GPIO_FUNC_NULL); // down button
@@ -680,50 +927,199 @@ void heatingLogic_temp() {
 
   if (heatingMode) { // if we think that we should be heating the enclosure:
     if ((inTemp + hysteresis) < setTemp) { // if the inside temp is <hysteresis> less than it should be:
-      setHeaters(true, false);
-      setFan(fanOffVal);
+      setHeat(HEATER_DEMAND_MAX);
+      setAirflow(fanOffVal);
 
     } else if ((inTemp - bigDiff) > setTemp) { // if the inside temp is much higher than it shuld be:
       heatingMode = false;
-      setHeaters(false, false);
-      setFan(fanMidVal);
+      setHeat(0);
+      setAirflow(fanMidVal);
 
     } else if (inTemp > setTemp) { // if the inside temp is higher than it should be:
-      setHeaters(false, false);
-      setFan(fanOffVal);
+      setHeat(0);
+      setAirflow(fanOffVal);
     }
 
   } else { // if we think we should be cooling the enclosure:
     if (inTemp > setTemp) { // if the inside temp is hotter than itshould be
-      setHeaters(false, false); // turn off the heaters
+      setHeat(0); // turn off the heaters
 
       if (inTemp > (setTemp + hysteresis)) { // if the hysteresis were just triggered (if the inside temp is too hot by enough)
         hysteresisTriggered = true;
       }
 
       if (hysteresisTriggered) {
-        if (inTemp > (setTemp + bigDiff)) { // if the inside temp is too high by a large enough margin that it would brake the maping logic
-          setFan(fanOnVal); // turn on the fan
-
-        } else { // if the maping logic won't be broken
-          setFan(map(inTemp, setTemp, (setTemp + bigDiff), fanOffVal, fanOnVal)); // set the fan to a value coresponding to how different the temp is from the target
-        }
+        setAirflow(fanCurveAirflow(inTempFine - (static_cast<int16_t>(setTemp) << TEMP_FRACTION_BITS))); // set the airflow from the fan curve
 
       } else {
-        setFan(fanOffVal); // turn off the fan
+        setAirflow(fanOffVal); // turn off the fan
       }
 
     } else if ((inTemp + bigDiff) < setTemp) { // if the inside temp is much less than it should be
       heatingMode = true; // we should be heating, not cooling
       hysteresisTriggered = false;
-      setHeaters(true, false); // turn on the heater
-      setFan(fanOffVal); // turn off the fan
+      setHeat(HEATER_DEMAND_MAX); // turn on the heaters
+      setAirflow(fanOffVal); // turn off the fan
 
     } else { // if the inside temp is just a bit less than it should be, or what it should be
       hysteresisTriggered = false;
-      setHeaters(false, false); // turn off the heaters
-      setFan(fanOffVal);
+      setHeat(0); // turn off the heaters
+      setAirflow(fanOffVal);
+    }
+  }
+}
+
+void heatingLogic_pid() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("heatingLogic_pid() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  static uint32_t lastUpdateTime = 0; // the tempReadTime the controller was last updated with
+
+  setPSU(true); // ensure the fan, heaters, and servos have power
+
+  if (oldMode != MODE_PRINTING || oldControlMode != CONTROL_MODE_PID) { // if the controller wasn't running last loop, start it fresh
+    temperaturePID.reset();
+    lastUpdateTime = tempReadTime;
+  }
+
+  if (tempReadTime != lastUpdateTime) { // only update with new readings, so the integral and derivative see real time steps
+    temperaturePID.setGains(pidKp, pidKi, pidKd);
+    temperaturePID.update(static_cast<int16_t>(globalSetTemp) << TEMP_FRACTION_BITS, inTempFine, tempReadTime - lastUpdateTime);
+    lastUpdateTime = tempReadTime;
+  }
+
+  applyControlOutput(temperaturePID.getOutput());
+}
+
+void heatingLogic_autotune() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("heatingLogic_autotune() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  static uint32_t lastUpdateTime = 0; // the tempReadTime autotuning was last updated with
+  static uint32_t startTime = 0; // when autotuning started
+
+  setPSU(true); // ensure the fan, heaters, and servos have power
+
+  if (oldMode != MODE_PRINTING || oldControlMode != CONTROL_MODE_AUTOTUNE) { // if autotuning wasn't running last loop, start it fresh
+    pidAutotune.start(static_cast<int16_t>(globalSetTemp) << TEMP_FRACTION_BITS, inTempFine);
+    lastUpdateTime = tempReadTime;
+    startTime = millis();
+  }
+
+  if (tempReadTime != lastUpdateTime) {
+    pidAutotune.update(inTempFine, tempReadTime);
+    lastUpdateTime = tempReadTime;
+  }
+
+  if (pidAutotune.isDone()) {
+    uint16_t kp, ki, kd;
+
+    if (pidAutotune.getGains(kp, ki, kd)) { // keep the new gains (they are menu items, so they are saved with the other settings) and start using them
+      pidKp = min(kp, static_cast<uint16_t>(MAX_PID_GAIN));
+      pidKi = min(ki, static_cast<uint16_t>(MAX_PID_GAIN));
+      pidKd = min(kd, static_cast<uint16_t>(MAX_PID_GAIN));
+      controlMode = CONTROL_MODE_PID;
+
+    } else {
+      controlMode = CONTROL_MODE_TEMP;
     }
+
+    #if DEBUG
+    Serial.printf("heatingLogic_autotune() finished: kp %u, ki %u, kd %u.\n", pidKp.load(), pidKi.load(), pidKd.load()); // print a debug message over USB
+    #endif
+
+  } else if (millis() - startTime > AUTOTUNE_TIMEOUT) { // it never oscillated (e.g. the heater can't reach the set temp)
+    controlMode = CONTROL_MODE_TEMP;
+
+    #if DEBUG
+    Serial.printf("heatingLogic_autotune() timed out.\n"); // print a debug message over USB
+    #endif
+  }
+
+  applyControlOutput(pidAutotune.getOutput());
+}
+
+void heatingLogic_cascade() {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("heatingLogic_cascade() called from core%u.\n", core); // print a debug message over USB
+  #endif
+
+  static uint32_t lastUpdateTime = 0; // the tempReadTime the outer controller was last updated with
+  static uint32_t lastHeaterUpdate = 0; // when the inner controller was last updated (ms)
+  static int16_t heaterSetTemp = 0; // the heater temp the outer controller asked for
+
+  setPSU(true); // ensure the fan, heaters, and servos have power
+
+  int16_t setTemp = static_cast<int16_t>(globalSetTemp) << TEMP_FRACTION_BITS;
+  int16_t limit = static_cast<int16_t>(min(heaterTempLimit.load(), static_cast<uint8_t>(MAX_HEATER_TEMP - HEATER_TEMP_LIMIT_MARGIN))) << TEMP_FRACTION_BITS;
+
+  if (oldMode != MODE_PRINTING || oldControlMode != CONTROL_MODE_CASCADE) { // if the controllers weren't running last loop, start them fresh
+    temperaturePID.reset();
+    heaterPID.reset();
+    lastUpdateTime = tempReadTime;
+    lastHeaterUpdate = millis() - HEATER_PID_INTERVAL; // so the heater is read right away
+    heaterSetTemp = setTemp;
+  }
+
+  if (tempReadTime != lastUpdateTime) { // the outer (air) loop only updates with new readings, so the integral and derivative see real time steps
+    uint32_t dt = tempReadTime - lastUpdateTime;
+    lastUpdateTime = tempReadTime;
+
+    temperaturePID.setGains(pidKp, pidKi, pidKd);
+    int16_t airOutput = temperaturePID.update(setTemp, inTempFine, dt);
+
+    // the outer output is how far between the set temp and the limit the heater should be
+    heaterSetTemp = setTemp + (static_cast<int32_t>(max(airOutput, static_cast<int16_t>(0))) * max(limit - setTemp, 0)) / PID_OUTPUT_MAX;
+  }
+
+  if (millis() - lastHeaterUpdate >= HEATER_PID_INTERVAL) { // the inner (heater) loop runs much faster, on its own readings
+    uint32_t now = millis();
+    uint32_t dt = now - lastHeaterUpdate;
+    lastHeaterUpdate = now;
+
+    readHeaterTemp();
+
+    if (temperaturePID.getOutput() > 0) {
+      heaterPID.setGains(HEATER_PID_KP, HEATER_PID_KI, HEATER_PID_KD);
+      heaterPID.update(heaterSetTemp, heaterTempFine, dt);
+
+    } else { // not heating, so don't let the inner controller wind up
+      heaterPID.reset();
+    }
+  }
+
+  if (temperaturePID.getOutput() > 0) {
+    int16_t demand = (heaterTempFine >= limit) ? 0 : max(heaterPID.getOutput(), static_cast<int16_t>(0)); // never heat past the limit, whatever the inner controller says | the heater temp is at most HEATER_PID_INTERVAL old
+
+    setHeat((static_cast<uint32_t>(demand) * HEATER_DEMAND_MAX) / PID_OUTPUT_MAX);
+    setAirflow(fanOffVal);
+
+  } else {
+    applyControlOutput(temperaturePID.getOutput()); // cool (or idle) as CONTROL_MODE_PID does
+  }
+}
+
+void applyControlOutput(int16_t output) {
+  #if DEBUG
+  uint8_t core = rp2040.cpuid();
+  Serial.printf("applyControlOutput(%d) called from core%u.\n", output, core); // print a debug message over USB
+  #endif
+
+  if (output > 0) { // heat: the heater is on for <output> / PID_OUTPUT_MAX of each window
+    setHeat((static_cast<uint32_t>(output) * HEATER_DEMAND_MAX) / PID_OUTPUT_MAX);
+    setAirflow(fanOffVal);
+
+  } else { // cool: full cooling is the last point of the fan curve
+    uint8_t lastPoint = constrain(fanCurvePoints.load(), static_cast<uint8_t>(1), static_cast<uint8_t>(FAN_CURVE_MAX_POINTS)) - 1;
+    int32_t fullCoolingError = static_cast<int32_t>(fanCurveErrors[lastPoint]) << TEMP_FRACTION_BITS;
+
+    setHeat(0);
+    setAirflow((output < 0) ? fanCurveAirflow((-output * fullCoolingError) / PID_OUTPUT_MAX) : fanOffVal.load());
   }
 }
 
@@ -46,6 +46,11 @@ std::vector<uint8_t> base2ToBase4(uint8_t inut);
 */
 void blinkLED();
 
+/**
+* @brief returns the pattern the print done light should show (attention, then cooling, then done), or nullptr if it should just follow printDone
+*/
+const lights::Pattern* printDonePattern();
+
 /**
 * @brief blinks out an error code through the built-in LED
 */
@@ -90,14 +95,40 @@ bool isScreenConnected();
 bool setPSU(bool state);
 
 /**
-* @brief to be called each loop, updates the servos
+* @brief to be called each loop, runs the vent: starts the flaps moving when the vent is opened or closed, and detaches the servos once they have settled | never blocks; the moves are done by servoTick()
+*/
+void updateVent();
+
+/**
+* @brief sets if the vent should be open or closed
+*/
+void setVent(bool open);
+
+/**
+* @brief returns true if the flaps have finished opening (going by their trajectories)
+*/
+bool ventIsOpen();
+
+/**
+* @brief starts the servos moving to new positions, attaching them first if needed
+*/
+void moveServos(uint8_t s1_Pos, uint8_t s2_Pos);
+
+/**
+* @brief sets the airflow the fan should give (0 - 255, as a fraction of fanMaxRPM) | the fan's duty cycle is found from its measured speed, so the airflow stays the same as the fan or filters change
 */
-void updateServos();
+void setAirflow(uint8_t airflow);
 
 /**
-* @brief sets the position of the servos
+* @brief finds the airflow the fan curve gives for a temperature error
+* @param error how far the inside temp is above the set temp, with TEMP_FRACTION_BITS fractional bits
 */
-void setServos(uint8_t s1_Pos, uint8_t s2_Pos);
+uint8_t fanCurveAirflow(int16_t error);
+
+/**
+* @brief raises any point of the fan curve that would run the fan below FAN_MIN_RPM (other than off) | call after the curve or fanMaxRPM are changed
+*/
+void fixFanCurve();
 
 /**
 * @brief call every loop, handels updating the fan
@@ -105,15 +136,25 @@ void setServos(uint8_t s1_Pos, uint8_t s2_Pos);
 void updateFan();
 
 /**
-* @brief sets the speed (duty cycle) of the fan
+* @brief sets the speed (duty cycle) of the fan directly (open loop)
 */
 void setFan(uint8_t dutyCycle);
 
 /**
-* @brief sets the state of both heaters
+* @brief sets the state of both heaters (fully on or off) | they still won't switch sooner than the minimum on and off times allow
 */
 void setHeaters(bool h1_On, bool h2_On);
 
+/**
+* @brief sets how much each heater should heat (0 - HEATER_DEMAND_MAX) | heaterTick() turns this into on and off periods; the heaters are stopped at once if the door is open
+*/
+void setHeaterDemand(uint16_t h1_Demand, uint16_t h2_Demand);
+
+/**
+* @brief spreads a heat demand (0 - HEATER_DEMAND_MAX) over both heaters: the leading heater takes it alone, unless heaterStager decides both should heat | the heaters take turns leading, going by how long each has been on
+*/
+void setHeat(uint16_t demand);
+
 /**
 * @brief starts serial (USB) comunication (takes ~10ms) | returns 1 if a computer is connected, 0 if not
 */
@@ -129,6 +170,11 @@ uint32_t readTempSensor(Adafruit_MCP9808* sensor, uint8_t sensorID, uint8_t SCAL
 */
 bool getTemp();
 
+/**
+* @brief reads just the heater temp (once, into heaterTemp and heaterTempFine), for the cascade controller's inner loop
+*/
+void readHeaterTemp();
+
 /**
 * @brief called if the lightswitch was pressed. does the stuff that should be done when this happens
 */
@@ -164,6 +210,26 @@ void gpioDisable();
 */
 void heatingLogic_temp();
 
+/**
+* @brief handels the logic for controling the heaters and fan when the control mode is set to CONTROL_MODE_PID
+*/
+void heatingLogic_pid();
+
+/**
+* @brief handels the logic for controling the heaters and fan when the control mode is set to CONTROL_MODE_AUTOTUNE | switches to CONTROL_MODE_PID with the new gains once done
+*/
+void heatingLogic_autotune();
+
+/**
+* @brief handels the logic for controling the heaters and fan when the control mode is set to CONTROL_MODE_CASCADE: temperaturePID sets a target heater temp (up to heaterTempLimit) with each temp reading, and heaterPID holds the heater there, reading the heater temp every HEATER_PID_INTERVAL
+*/
+void heatingLogic_cascade();
+
+/**
+* @brief drives the heaters and fan from a controller's output (-PID_OUTPUT_MAX - PID_OUTPUT_MAX): the heaters' demand while heating, the fan curve while cooling
+*/
+void applyControlOutput(int16_t output);
+
 /**
 * @brief handels the logic for controling the heaters and fan when the control mode is set to controlMode_MANUAL
 */
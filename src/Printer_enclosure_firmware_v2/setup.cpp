@@ -48,6 +48,11 @@ void servoSetup() {
   //  move servos to home position (closed, or 0deg):
   servo1.write(servo1Closed);
   servo2.write(servo2Closed);
+  servo1Trajectory.setPosition(servo1Closed);
+  servo2Trajectory.setPosition(servo2Closed);
+  ventState = VENT_CLOSING; // so updateVent() detaches the servos once they have had time to get there
+
+  add_repeating_timer_ms(-SERVO_TICK_INTERVAL, servoTick, nullptr, &servoTimer); // negative, so the interval is from the start of one tick to the start of the next
 
   #if DEBUG
   Serial.printf("Exiting servoSetup().\n"); // print a debug message over USB
@@ -211,6 +216,34 @@ void buttonSetup() {
   #endif
 }
 
+void fanSetup() {
+  #if DEBUG
+  Serial.printf("fanSetup() called.\n"); // print a debug message over USB
+  #endif
+
+  fanOutput.begin(); // start the fan's PWM (off)
+  #if FAN_HAS_TACH
+  fanTach.begin(); // start counting tachometer pulses
+  fanRPMMenuItem->setIsEditable(false); // the RPM is only there to be read
+  #endif
+
+  #if DEBUG
+  Serial.printf("Exiting fanSetup().\n"); // print a debug message over USB
+  #endif
+}
+
+void heaterSetup() {
+  #if DEBUG
+  Serial.printf("heaterSetup() called.\n"); // print a debug message over USB
+  #endif
+
+  add_repeating_timer_ms(-HEATER_TICK_INTERVAL, heaterTick, nullptr, &heaterTimer); // negative, so the interval is from the start of one tick to the start of the next
+
+  #if DEBUG
+  Serial.printf("Exiting heaterSetup().\n"); // print a debug message over USB
+  #endif
+}
+
 void pinSetup() {
   #if DEBUG
   Serial.printf("pinSetup() called.\n"); // print a debug message over USB
@@ -239,6 +272,14 @@ void pinSetup() {
   #endif
 }
 
+void lightSetup() {
+  #if DEBUG
+  Serial.printf("lightSetup() called.\n"); // print a debug message over USB
+  #endif
+
+  lightManager.begin(); // the fade interrupt will run on this core
+}
+
 bool menuSetup() {
   #if DEBUG
   Serial.printf("menuSetup() called.\n"); // print a debug message over USB
@@ -358,6 +399,8 @@ bool menuRecovery() {
     mainMenu[i]->setData(recoveredData);
   }
 
+  fixFanCurve(); // a curve saved by an older build could stall the fan
+
   return true; // data recovered
 }  //  menuRecovery()
 
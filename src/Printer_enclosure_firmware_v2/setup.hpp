@@ -44,7 +44,7 @@
 void varInit();
 
 /**
-* @brief attaches the servos, moves them to closed position
+* @brief attaches the servos, moves them to closed position (updateVent() detaches them once they're there)
 */
 void servoSetup();
 
@@ -53,6 +53,16 @@ void servoSetup();
 */
 bool tempSensorSetup();
 
+/**
+* @brief starts measuring the fan's speed
+*/
+void fanSetup();
+
+/**
+* @brief starts the timer that drives the heaters (off until they are given a demand)
+*/
+void heaterSetup();
+
 /**
 * @brief sets up I2C0, or the one connected to the printer
 */
@@ -68,6 +78,11 @@ void buttonSetup();
 */
 void pinSetup();
 
+/**
+* @brief sets up the lights for PWM and starts the interrupt that runs their fades | call from core1
+*/
+void lightSetup();
+
 /**
 * @brief attempts to start the screen, and verifies it is responsive on the I2C bus. If sucessfull, displays a "Loading..." splash screen
 */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "tempGraph.hpp"
+
+graph::History::History() : history_clears(0), history_window(DEFAULT_GRAPH_WINDOW) {
+  history_columnTime = (static_cast<uint32_t>(history_window) * 60000) / SCREEN_WIDTH;
+  clear();
+}
+
+void graph::History::clear() {
+  history_head = 0;
+  history_size = 0;
+  history_added = 0;
+  history_clears++;
+  history_columnStart = millis();
+  history_lastReading = 0;
+  history_readings = 0;
+
+  for (uint8_t i = 0; i < 4; i++) history_sums[i] = 0;
+}
+
+void graph::History::setWindow(uint16_t minutes) {
+  minutes = constrain(minutes, MIN_GRAPH_WINDOW, MAX_GRAPH_WINDOW);
+
+  if (minutes == history_window) return;
+
+  history_window = minutes;
+  history_columnTime = (static_cast<uint32_t>(minutes) * 60000) / SCREEN_WIDTH; // the columns get spread evenly over the window
+  clear(); // the old columns cover the wrong amount of time
+}
+
+bool graph::History::tick(uint32_t now, int16_t in, int16_t out, int16_t heater, uint8_t set) {
+  if (history_readings != 0 && (now - history_lastReading) < GRAPH_SAMPLE_INTERVAL) return false; // not time for a new reading
+
+  history_lastReading = now;
+  history_sums[0] += in;
+  history_sums[1] += out;
+  history_sums[2] += heater;
+  history_sums[3] += set;
+  history_readings++;
+
+  if ((now - history_columnStart) < history_columnTime) return false; // the column isn't done yet
+
+  Sample& sample = history_samples[history_head];
+  sample.in = constrain(history_sums[0] / history_readings, INT8_MIN, INT8_MAX);
+  sample.out = constrain(history_sums[1] / history_readings, INT8_MIN, INT8_MAX);
+  sample.heater = constrain(history_sums[2] / history_readings, INT8_MIN, INT8_MAX);
+  sample.set = history_sums[3] / history_readings;
+
+  history_head = (history_head + 1) % SCREEN_WIDTH;
+  if (history_size < SCREEN_WIDTH) history_size++;
+  history_added++;
+
+  history_columnStart += history_columnTime;
+  if ((now - history_columnStart) >= history_columnTime) history_columnStart = now; // don't try to catch up if we fell far behind
+
+  history_readings = 0;
+  for (uint8_t i = 0; i < 4; i++) history_sums[i] = 0;
+
+  return true;
+}
+
+uint8_t graph::History::size() const {
+  return history_size;
+}
+
+const graph::Sample& graph::History::get(uint8_t age) const {
+  return history_samples[(history_head + SCREEN_WIDTH - 1 - age) % SCREEN_WIDTH];
+}
+
+uint32_t graph::History::getAdded() const {
+  return history_added;
+}
+
+uint32_t graph::History::getClears() const {
+  return history_clears;
+}
+
+graph::Plot::Plot() : plot_drawnAdded(0), plot_drawnClears(0), plot_valid(false) {
+  memset(plot_pixels, 0, sizeof(plot_pixels));
+}
+
+void graph::Plot::update(const History& history) {
+  if (plot_valid && history.getClears() == plot_drawnClears) {
+    if (history.getAdded() == plot_drawnAdded) return; // nothing new
+
+    if (history.getAdded() == (plot_drawnAdded + 1)) { // just one new column; shift everything over and draw it
+      shift();
+      drawColumn(SCREEN_WIDTH - 1, history.getAdded() - 1, history.get(0), (history.size() > 1) ? &history.get(1) : nullptr);
+      plot_drawnAdded = history.getAdded();
+      return;
+    }
+  }
+
+  redraw(history);
+}
+
+void graph::Plot::redraw(const History& history) {
+  memset(plot_pixels, 0, sizeof(plot_pixels));
+
+  for (uint8_t age = 0; age < history.size(); age++) { // for each column, newest on the right
+    drawColumn(SCREEN_WIDTH - 1 - age, history.getAdded() - 1 - age, history.get(age), ((age + 1) < history.size()) ? &history.get(age + 1) : nullptr);
+  }
+
+  plot_drawnAdded = history.getAdded();
+  plot_drawnClears = history.getClears();
+  plot_valid = true;
+}
+
+void graph::Plot::shift() {
+  for (uint8_t page = 0; page < PAGES; page++) {
+    memmove(plot_pixels[page], plot_pixels[page] + 1, SCREEN_WIDTH - 1);
+    plot_pixels[page][SCREEN_WIDTH - 1] = 0;
+  }
+}
+
+void graph::Plot::drawColumn(uint8_t x, uint32_t index, const Sample& sample, const Sample* previous) {
+  // the inside and heater temps are drawn as lines (joined to the column before), the outside temp as dots, and the set temp dotted
+  drawSpan(x, tempToY(sample.in), tempToY(previous ? previous->in : sample.in));
+  drawSpan(x, tempToY(sample.heater), tempToY(previous ? previous->heater : sample.heater));
+  setPixel(x, tempToY(sample.out));
+  if (index & 1) setPixel(x, tempToY(sample.set)); // every other column (counted from when the history was cleared, so the dots don't move as the graph shifts)
+}
+
+void graph::Plot::setPixel(uint8_t x, int16_t y) {
+  if (y < 0 || y >= HEIGHT) return;
+
+  plot_pixels[y >> 3][x] |= (1 << (y & 7));
+}
+
+void graph::Plot::drawSpan(uint8_t x, int16_t y1, int16_t y2) {
+  if (y1 > y2) std::swap(y1, y2);
+
+  for (int16_t y = y1; y <= y2; y++) { // fill in every pixel between the two points, so steep changes still look like a line
+    setPixel(x, y);
+  }
+}
+
+int16_t graph::Plot::tempToY(int16_t temp) {
+  return (HEIGHT - 1) - ((temp - GRAPH_MIN_TEMP) / GRAPH_DEGREES_PER_PIXEL); // higher temperatures are closer to the top
+}
+
+void graph::Plot::draw(uint8_t* buffer) const {
+  memcpy(buffer + (2 * SCREEN_WIDTH), plot_pixels, sizeof(plot_pixels)); // the header takes up the first two pages
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include "config.hpp"
+#include <Arduino.h>
+
+namespace graph {
+  /**
+  * @brief one column of the graph (the average of all the readings taken while it was being filled)
+  */
+  struct Sample {
+    int8_t in; ///< the temperature inside the enclosure
+    int8_t out; ///< the temperature outside the enclosure
+    int8_t heater; ///< the temperature of the heater
+    uint8_t set; ///< the set temperature
+  };
+
+  /**
+  * @brief a ring buffer of the last <SCREEN_WIDTH> graph columns, downsampled so that they cover a set window of time
+  */
+  class History {
+    public:
+      History();
+
+      /**
+      * @brief sets how much time the whole graph covers | if it changes the history is cleared
+      * @param minutes the length of the window, in minutes
+      */
+      void setWindow(uint16_t minutes);
+
+      /**
+      * @brief takes a reading (at most once every GRAPH_SAMPLE_INTERVAL ms), and adds a new column once enough time has passed to fill one
+      * @param now the current time, in milliseconds
+      * @return true if a new column was added
+      */
+      bool tick(uint32_t now, int16_t in, int16_t out, int16_t heater, uint8_t set);
+
+      /**
+      * @brief returns the number of columns stored
+      */
+      uint8_t size() const;
+
+      /**
+      * @brief returns a column
+      * @param age how many columns ago the column was added (0 is the newest)
+      */
+      const Sample& get(uint8_t age) const;
+
+      /**
+      * @brief returns the total number of columns added sience the history was last cleared
+      */
+      uint32_t getAdded() const;
+
+      /**
+      * @brief returns the number of times the history has been cleared
+      */
+      uint32_t getClears() const;
+
+    private:
+      Sample history_samples[SCREEN_WIDTH]; ///< the stored columns
+      uint8_t history_head; ///< where the next column will go
+      uint8_t history_size; ///< how many columns are stored
+      uint32_t history_added; ///< how many columns have been added sience the last clear
+      uint32_t history_clears; ///< how many times the history has been cleared
+
+      uint16_t history_window; ///< the length of the window, in minutes
+      uint32_t history_columnTime; ///< how long each column covers, in milliseconds
+      uint32_t history_columnStart; ///< when the column being filled was started
+      uint32_t history_lastReading; ///< when the last reading was taken
+
+      int32_t history_sums[4]; ///< the sums of the readings for the column being filled
+      uint16_t history_readings; ///< how many readings have been taken for the column being filled
+
+      void clear();
+  };
+
+  /**
+  * @brief an offscreen copy of the graph area (everything below the header), kept up to date one column at a time
+  */
+  class Plot {
+    public:
+      Plot();
+
+      /**
+      * @brief brings the plot up to date with the history; if only one column was added the plot is shifted and only that column is drawn, otherwise it is redrawn
+      */
+      void update(const History& history);
+
+      /**
+      * @brief copies the plot into an SSD1306 frame buffer, below the header
+      */
+      void draw(uint8_t* buffer) const;
+
+    private:
+      static constexpr uint8_t PAGES = (SCREEN_HEIGHT - 16) / 8; ///< the number of pages the plot covers
+      static constexpr uint8_t HEIGHT = PAGES * 8; ///< the height of the plot, in pixels
+
+      uint8_t plot_pixels[PAGES][SCREEN_WIDTH]; ///< the plot, page-organized like the frame buffer
+      uint32_t plot_drawnAdded; ///< the number of columns the history had added when the plot was last drawn
+      uint32_t plot_drawnClears; ///< the number of times the history had been cleared when the plot was last drawn
+      bool plot_valid; ///< false if the plot needs to be redrawn
+
+      void redraw(const History& history);
+      void shift();
+      void drawColumn(uint8_t x, uint32_t index, const Sample& sample, const Sample* previous);
+      void setPixel(uint8_t x, int16_t y);
+      void drawSpan(uint8_t x, int16_t y1, int16_t y2);
+      static int16_t tempToY(int16_t temp);
+  };
+}
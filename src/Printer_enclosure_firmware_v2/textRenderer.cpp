@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#include "textRenderer.hpp"
+
+namespace {
+  constexpr uint8_t FIRST_CHAR = ' '; ///< the first character in the font
+  constexpr uint8_t LAST_CHAR = '~'; ///< the last character in the font
+  constexpr uint8_t CHAR_COUNT = LAST_CHAR - FIRST_CHAR + 1; ///< the number of characters in the font
+
+  /// the classic 5x7 font (the same one Adafruit_GFX uses by default), one byte per column, least significant bit at the top
+  constexpr uint8_t font5x7[CHAR_COUNT][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // '%'
+    {0x36, 0x49, 0x56, 0x20, 0x50}, // '&'
+    {0x00, 0x08, 0x07, 0x03, 0x00}, // '''
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // ')'
+    {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // '+'
+    {0x00, 0x80, 0x70, 0x30, 0x00}, // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // '-'
+    {0x00, 0x00, 0x60, 0x60, 0x00}, // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // '1'
+    {0x72, 0x49, 0x49, 0x49, 0x46}, // '2'
+    {0x21, 0x41, 0x49, 0x4D, 0x33}, // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x31}, // '6'
+    {0x41, 0x21, 0x11, 0x09, 0x07}, // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // '8'
+    {0x46, 0x49, 0x49, 0x29, 0x1E}, // '9'
+    {0x00, 0x00, 0x14, 0x00, 0x00}, // ':'
+    {0x00, 0x40, 0x34, 0x00, 0x00}, // ';'
+    {0x00, 0x08, 0x14, 0x22, 0x41}, // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // '='
+    {0x00, 0x41, 0x22, 0x14, 0x08}, // '>'
+    {0x02, 0x01, 0x59, 0x09, 0x06}, // '?'
+    {0x3E, 0x41, 0x5D, 0x59, 0x4E}, // '@'
+    {0x7C, 0x12, 0x11, 0x12, 0x7C}, // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // 'C'
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // 'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, // 'F'
+    {0x3E, 0x41, 0x41, 0x51, 0x73}, // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // 'L'
+    {0x7F, 0x02, 0x1C, 0x02, 0x7F}, // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // 'R'
+    {0x26, 0x49, 0x49, 0x49, 0x32}, // 'S'
+    {0x03, 0x01, 0x7F, 0x01, 0x03}, // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // 'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // 'X'
+    {0x03, 0x04, 0x78, 0x04, 0x03}, // 'Y'
+    {0x61, 0x59, 0x49, 0x4D, 0x43}, // 'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x41}, // '['
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // '\'
+    {0x00, 0x41, 0x41, 0x41, 0x7F}, // ']'
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // '^'
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // '_'
+    {0x00, 0x03, 0x07, 0x08, 0x00}, // '`'
+    {0x20, 0x54, 0x54, 0x78, 0x40}, // 'a'
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, // 'b'
+    {0x38, 0x44, 0x44, 0x44, 0x28}, // 'c'
+    {0x38, 0x44, 0x44, 0x28, 0x7F}, // 'd'
+    {0x38, 0x54, 0x54, 0x54, 0x18}, // 'e'
+    {0x00, 0x08, 0x7E, 0x09, 0x02}, // 'f'
+    {0x18, 0xA4, 0xA4, 0x9C, 0x78}, // 'g'
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, // 'h'
+    {0x00, 0x44, 0x7D, 0x40, 0x00}, // 'i'
+    {0x20, 0x40, 0x40, 0x3D, 0x00}, // 'j'
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, // 'k'
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, // 'l'
+    {0x7C, 0x04, 0x78, 0x04, 0x78}, // 'm'
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, // 'n'
+    {0x38, 0x44, 0x44, 0x44, 0x38}, // 'o'
+    {0xFC, 0x18, 0x24, 0x24, 0x18}, // 'p'
+    {0x18, 0x24, 0x24, 0x18, 0xFC}, // 'q'
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, // 'r'
+    {0x48, 0x54, 0x54, 0x54, 0x24}, // 's'
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, // 't'
+    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // 'u'
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // 'v'
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // 'w'
+    {0x44, 0x28, 0x10, 0x28, 0x44}, // 'x'
+    {0x4C, 0x90, 0x90, 0x90, 0x7C}, // 'y'
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, // 'z'
+    {0x00, 0x08, 0x36, 0x41, 0x00}, // '{'
+    {0x00, 0x00, 0x77, 0x00, 0x00}, // '|'
+    {0x00, 0x41, 0x36, 0x08, 0x00}, // '}'
+    {0x02, 0x01, 0x02, 0x04, 0x02}  // '~'
+  };
+
+  /**
+  * @brief the font, precomputed at compile time into the columns that get copied to the screen
+  */
+  struct Fonts {
+    uint8_t small[CHAR_COUNT][CHARACTER_WIDTH]; ///< 6x8 glyphs (the 5x7 glyph plus a blank column)
+    uint16_t big[CHAR_COUNT][CHARACTER_WIDTH * 2]; ///< 12x16 glyphs (each pixel of the small glyph doubled in both directions)
+  };
+
+  /**
+  * @brief returns a column of pixels with every pixel doubled (8 pixels tall becomes 16 pixels tall)
+  */
+  constexpr uint16_t doubleColumn(uint8_t column) {
+    uint16_t doubled = 0;
+
+    for (uint8_t i = 0; i < 8; i++) { // for each pixel in the column
+      if (column & (1 << i)) {
+        doubled |= 0x3 << (i * 2); // set both of the pixels it turns into
+      }
+    }
+
+    return doubled;
+  }
+
+  constexpr Fonts makeFonts() {
+    Fonts fonts {};
+
+    for (uint8_t c = 0; c < CHAR_COUNT; c++) { // for each character
+      for (uint8_t col = 0; col < CHARACTER_WIDTH; col++) { // for each column of the small glyph
+        uint8_t column = (col < 5) ? font5x7[c][col] : 0; // the last column is always blank
+
+        fonts.small[c][col] = column;
+        fonts.big[c][col * 2] = doubleColumn(column);
+        fonts.big[c][(col * 2) + 1] = doubleColumn(column);
+      }
+    }
+
+    return fonts;
+  }
+
+  constexpr Fonts fonts = makeFonts();
+
+  /**
+  * @brief writes one column of pixels into the frame buffer, overwriting everything in its height (the background is drawn too)
+  * @param bits the pixels in the column, least significant bit at the top
+  * @param height the height of the column (8 or 16)
+  */
+  inline void writeColumn(uint8_t* buffer, int16_t x, int16_t y, uint16_t bits, uint8_t height, bool invert) {
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return; // off the screen
+
+    uint8_t shift = y & 7; // how far down from the top of its page the column starts
+    uint32_t mask = ((1UL << height) - 1) << shift; // the bits that will be overwritten
+    uint32_t value = (static_cast<uint32_t>(invert ? ~bits : bits) << shift) & mask; // the bits that will be written
+
+    uint8_t* byte = buffer + ((y >> 3) * SCREEN_WIDTH) + x; // the first byte (in the first page) that the column touches
+
+    for (uint8_t page = (y >> 3); mask && page < (SCREEN_HEIGHT / 8); page++) { // for each page the column touches
+      *byte = (*byte & ~static_cast<uint8_t>(mask)) | static_cast<uint8_t>(value);
+
+      mask >>= 8; // move on to the next page
+      value >>= 8;
+      byte += SCREEN_WIDTH;
+    }
+  }
+}
+
+int16_t text::drawChar(uint8_t* buffer, int16_t x, int16_t y, char c, uint8_t size, bool invert) {
+  uint8_t index = static_cast<uint8_t>(c);
+
+  if (index < FIRST_CHAR || index > LAST_CHAR) { // if there is no glyph for the character
+    index = '?';
+  }
+
+  index -= FIRST_CHAR;
+
+  if (size == 2) {
+    for (uint8_t col = 0; col < (CHARACTER_WIDTH * 2); col++) {
+      writeColumn(buffer, x + col, y, fonts.big[index][col], CHARACTER_HEIGHT * 2, invert);
+    }
+
+    return x + (CHARACTER_WIDTH * 2);
+  }
+
+  for (uint8_t col = 0; col < CHARACTER_WIDTH; col++) {
+    writeColumn(buffer, x + col, y, fonts.small[index][col], CHARACTER_HEIGHT, invert);
+  }
+
+  return x + CHARACTER_WIDTH;
+}
+
+int16_t text::drawString(uint8_t* buffer, int16_t x, int16_t y, const char* str, uint8_t size, bool invert) {
+  for (; *str != '\0' && x < SCREEN_WIDTH; str++) { // for each character, stopping at the right edge of the screen
+    x = drawChar(buffer, x, y, *str, size, invert);
+  }
+
+  return x;
+}
+
+int16_t text::drawInt(uint8_t* buffer, int16_t x, int16_t y, int32_t value, uint8_t size, bool invert) {
+  char digits[12]; // enough for any int32_t, with a sign and a NULL
+  uint8_t pos = sizeof(digits) - 1;
+  uint32_t magnitude = (value < 0) ? -static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+
+  digits[pos] = '\0';
+
+  do { // fill the digits in from the right (least significant first)
+    digits[--pos] = '0' + (magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  if (value < 0) {
+    digits[--pos] = '-';
+  }
+
+  return drawString(buffer, x, y, digits + pos, size, invert);
+}
+
+uint16_t text::drawStripChar(uint8_t* strip, uint16_t stripWidth, uint16_t x, char c) {
+  uint8_t index = static_cast<uint8_t>(c);
+
+  if (index < FIRST_CHAR || index > LAST_CHAR) { // if there is no glyph for the character
+    index = '?';
+  }
+
+  index -= FIRST_CHAR;
+
+  for (uint8_t col = 0; col < CHARACTER_WIDTH && x < stripWidth; col++, x++) {
+    strip[x] = fonts.small[index][col];
+  }
+
+  return x;
+}
+
+void text::drawColumns(uint8_t* buffer, int16_t x, int16_t y, const uint8_t* columns, uint16_t count) {
+  if (x < 0) { // clip off the left edge
+    if (-x >= count) return;
+    columns -= x;
+    count += x;
+    x = 0;
+  }
+
+  if (x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return; // off the screen
+  if (count > (SCREEN_WIDTH - x)) count = SCREEN_WIDTH - x; // clip off the right edge
+
+  if ((y & 7) == 0) { // if the columns line up with a page, they can be copied straight in
+    memcpy(buffer + ((y >> 3) * SCREEN_WIDTH) + x, columns, count);
+    return;
+  }
+
+  for (uint16_t col = 0; col < count; col++) {
+    writeColumn(buffer, x + col, y, columns[col], CHARACTER_HEIGHT, false);
+  }
+}
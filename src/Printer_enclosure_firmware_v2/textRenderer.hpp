@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "config.hpp"
+#include <Arduino.h>
+
+namespace text {
+  /**
+  * @brief draws one character straight into an SSD1306 (page-organized) frame buffer, one byte-wide column at a time
+  * @param buffer the frame buffer to draw into (display.getBuffer())
+  * @param x the horizontal position of the left edge of the character, in pixels
+  * @param y the vertical position of the top of the character, in pixels (does not need to line up with a page)
+  * @param c the character to draw | characters outside of printable ASCII are drawn as '?'
+  * @param size 1 for a 6x8 character, 2 for a 12x16 character
+  * @param invert if true, black text on a white background is drawn instead of white text on black
+  * @return the horizontal position just after the character (where the next one should go)
+  */
+  int16_t drawChar(uint8_t* buffer, int16_t x, int16_t y, char c, uint8_t size, bool invert);
+
+  /**
+  * @brief draws a NULL-terminated string straight into an SSD1306 frame buffer
+  * @note parameters are the same as drawChar(), anything off the right edge of the screen is clipped
+  * @return the horizontal position just after the last character
+  */
+  int16_t drawString(uint8_t* buffer, int16_t x, int16_t y, const char* str, uint8_t size, bool invert);
+
+  /**
+  * @brief draws a signed integer (in base 10) straight into an SSD1306 frame buffer
+  * @note parameters are the same as drawChar()
+  * @return the horizontal position just after the last digit
+  */
+  int16_t drawInt(uint8_t* buffer, int16_t x, int16_t y, int32_t value, uint8_t size, bool invert);
+
+  /**
+  * @brief draws one size 1 character into a strip (a single page, <stripWidth> columns wide) instead of the screen
+  * @param strip the strip to draw into
+  * @param stripWidth the width of the strip, in pixels | anything past it is clipped
+  * @param x the horizontal position of the left edge of the character, in pixels
+  * @param c the character to draw | characters outside of printable ASCII are drawn as '?'
+  * @return the horizontal position just after the character
+  */
+  uint16_t drawStripChar(uint8_t* strip, uint16_t stripWidth, uint16_t x, char c);
+
+  /**
+  * @brief copies already-rendered columns (one byte each, like a strip) into an SSD1306 frame buffer
+  * @note if <y> lines up with a page this is a single memcpy, otherwise each column is shifted across two pages
+  * @param columns the columns to copy
+  * @param count how many columns to copy | anything off the right edge of the screen is clipped
+  */
+  void drawColumns(uint8_t* buffer, int16_t x, int16_t y, const uint8_t* columns, uint16_t count);
+}
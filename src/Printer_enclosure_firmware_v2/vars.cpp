@@ -26,6 +26,10 @@
 //  preferences (how it will opperate) | some of these are volitile, not constant, as they can be edited via the menu
 std::atomic<bool> lights_On_On_Door_Open = DEFAULT_LIGHTS_ON_ON_DOOR_OPEN;  //  controlls if the lights turn on when the door is opened.
 std::atomic<bool> saveStateOnPowerLoss = DEFAULT_SAVE_STATE_ON_POWER_LOSS;
+std::atomic<bool> showGraph = false;
+std::atomic<bool> pdl_Patterns = DEFAULT_PDL_PATTERNS;
+std::atomic<bool> fanLearning = DEFAULT_FAN_LEARNING && FAN_HAS_TACH; // there is nothing to learn from without a tachometer
+std::atomic<bool> heaterStaging = DEFAULT_HEATER_STAGING;
 
 std::atomic<uint8_t> nameScrollSpeed = DEFAULT_NAME_SCROLL_SPEED;
 std::atomic<uint8_t> menuScrollSpeed = DEFAULT_MENU_SCROLL_SPEED;
@@ -37,8 +41,6 @@ std::atomic<uint8_t> maxFanSpeed = defaultMaxFanSpeed.load();
 std::atomic<uint8_t> hysteresis = DEFAULT_HYSTERESIS;
 std::atomic<uint8_t> bigDiff = DEFAULT_BIG_DIFF;
 std::atomic<uint8_t> cooldownDif = DEFAULT_COOLDOWN_DIFF;
-std::atomic<uint8_t> dimingTime = DEFAULT_DIMING_TIME;
-std::atomic<uint8_t> pdl_DimingTime = DEFAULT_PDL_DIMING_TIME;
 std::atomic<uint8_t> i2cTempSensorRes = DEFAULT_I2C_TEMP_SENSOR_RES;
 std::atomic<uint8_t> servo1Open = DEFAULT_SERVO1_OPEN;
 std::atomic<uint8_t> servo2Open = DEFAULT_SERVO2_OPEN;
@@ -49,11 +51,32 @@ std::atomic<uint8_t> servo2Speed = DEFAULT_SERVO2_SPEED;
 std::atomic<uint8_t> sensorReadInterval = DEFAULT_SENSOR_READ_INTERVAL;
 std::atomic<uint8_t> controlMode = DEFAULT_CONTROL_MODE;
 std::atomic<uint8_t> sensorReads = DEFAULT_SENSOR_READS;
+std::atomic<uint8_t> lightLevel = DEFAULT_LIGHT_LEVEL;
+std::atomic<uint8_t> pdl_Level = DEFAULT_PDL_LEVEL;
+std::atomic<uint8_t> strip_Level = DEFAULT_STRIP_LEVEL;
+std::atomic<uint8_t> fanMinDuty = DEFAULT_FAN_MIN_DUTY;
+std::atomic<uint8_t> stage2Diff = DEFAULT_STAGE2_DIFF;
+std::atomic<uint8_t> stage2MinRise = DEFAULT_STAGE2_MIN_RISE;
+std::atomic<uint8_t> heaterTempLimit = DEFAULT_HEATER_TEMP_LIMIT;
+std::atomic<uint8_t> fanCurvePoints = DEFAULT_FAN_CURVE_POINTS;
+std::atomic<uint8_t> fanCurveErrors[FAN_CURVE_MAX_POINTS] = DEFAULT_FAN_CURVE_ERRORS;
+std::atomic<uint8_t> fanCurveAirflows[FAN_CURVE_MAX_POINTS] = DEFAULT_FAN_CURVE_AIRFLOWS;
 
 std::atomic<uint16_t> backupInterval = DEFAULT_BACKUP_INTERVAL; // the amount of time (in s) between backups of the menu data
 std::atomic<uint16_t> screensaverTime = DEFAULT_SCREENSAVER_TIME; // how long without user input intil the screensave is displayed (s)
 std::atomic<uint16_t> fanKickstartTime = DEFAULT_FAN_KICKSTART_TIME; //  the time (in miliseconds) that the fan will be turned on at 100% before being set to its target value
 std::atomic<uint16_t> menuButtonHoldTime = DEFAULT_MENU_BUTTON_HOLD_TIME;  //  how long the "up" or "down" buttons need to be held for to be counted as being held (in miliseconds)
+std::atomic<uint16_t> graphWindow = DEFAULT_GRAPH_WINDOW; // how much time the temperature graph covers (in minutes)
+std::atomic<uint16_t> dimingTime = DEFAULT_DIMING_TIME;
+std::atomic<uint16_t> pdl_DimingTime = DEFAULT_PDL_DIMING_TIME;
+std::atomic<uint16_t> strip_DimingTime = DEFAULT_STRIP_DIMING_TIME;
+std::atomic<uint16_t> pidKp = DEFAULT_PID_KP;
+std::atomic<uint16_t> pidKi = DEFAULT_PID_KI;
+std::atomic<uint16_t> pidKd = DEFAULT_PID_KD;
+std::atomic<uint16_t> heaterWindowTime = DEFAULT_HEATER_WINDOW_TIME;
+std::atomic<uint16_t> heaterMinOnTime = DEFAULT_HEATER_MIN_ON_TIME;
+std::atomic<uint16_t> heaterMinOffTime = DEFAULT_HEATER_MIN_OFF_TIME;
+std::atomic<uint16_t> fanMaxRPM = DEFAULT_FAN_MAX_RPM;
 
 //********************************************************************************************************************************************************************************
 
@@ -73,6 +96,8 @@ std::atomic<char> printName[256]; // an array of characters to store the print n
 
 std::atomic<int32_t> errorInfo = 0; // records aditionall info about any posible errors
 
+std::atomic<uint32_t> heapAllocations = 0; // counts calls to operator new (only when COUNT_HEAP_ALLOCATIONS is enabled)
+
 bool findPressedState = true;
 
 #if !manualPressedState
@@ -93,6 +118,8 @@ bool heatingMode = false;
 std::atomic<bool> PSUIsOn;
 std::atomic<bool> turnLightOff = false;
 std::atomic<bool> printDone = false;
+std::atomic<bool> needsAttention = false;
+std::atomic<bool> printNameChanged = false;
 std::atomic<bool> doorOpen = true;
 std::atomic<bool> lightSetState = false;
 std::atomic<bool> changeLights = false;
@@ -102,38 +129,77 @@ std::atomic<bool> startupError = false;
 std::atomic<bool> coreZeroStartup = false;
 std::atomic<bool> coreOneStartup = false;
 
-uint8_t targetFanSpeed = !FAN_ON * 255;
+uint8_t targetFanSpeed = 0;
+std::atomic<uint16_t> fanRPM = 0;
+bool fanClosedLoop = false;
 uint8_t oldControlMode = DEFAULT_CONTROL_MODE;
 uint8_t oldMode = DEFAULT_MODE;
 std::atomic<uint8_t> mode = DEFAULT_MODE;
 std::atomic<uint8_t> globalSetTemp = 20;
 volatile uint8_t errorOrigin = 0;
 
-uint8_t servo1SetPos;
-uint8_t servo2SetPos;
+uint8_t ventState = VENT_CLOSED;
+bool ventOpenRequested = false;
 
 int16_t heaterTemp = 20;
+int16_t heaterTempFine = 20 << TEMP_FRACTION_BITS;
 int16_t inTemp = 20;
+int16_t inTempFine = 20 << TEMP_FRACTION_BITS;
 int16_t outTemp = 20;
 
 uint32_t lastUserInput;
 
 uint32_t core1Time;
+uint32_t tempReadTime = 0;
 
 uint8_t menu::selectedItem = 0;
 uint8_t menu::topDisplayMenuItem = 0;
 uint8_t menu::bottomDisplayMenuItem = VISIBLE_MENU_ITEMS - 1;
 
-lights::Light printDoneLight(PRINT_DONE_LIGHT_PIN, pdl_DimingTime, PRINT_DONE_LIGHT_ON, false, &PSUIsOn);
-lights::Light mainLight(LIGHTS_PIN, dimingTime, MAIN_LIGHTS_ON, false, &PSUIsOn);
+lights::Light lightZones[LIGHT_ZONE_COUNT] = { // in LIGHT_ZONE_* order
+  {LIGHTS_PIN, LIGHT_PWM_FREQ, LIGHT_PWM_BITS, &dimingTime, &lightLevel, MAIN_LIGHTS_ON, !MAIN_LIGHTS_ON, &PSUIsOn},
+  {PRINT_DONE_LIGHT_PIN, FAN_PWM_FREQ, FAN_PWM_BITS, &pdl_DimingTime, &pdl_Level, PRINT_DONE_LIGHT_ON, !PRINT_DONE_LIGHT_ON, &PSUIsOn}, // shares PWM slice 0 with the fan, so it uses the fan's frequency and resolution
+  {LIGHT_STRIP_PIN, LIGHT_PWM_FREQ, LIGHT_PWM_BITS, &strip_DimingTime, &strip_Level, LIGHT_STRIP_ON, !LIGHT_STRIP_ON, &PSUIsOn}
+};
+
+lights::Light& mainLight = lightZones[LIGHT_ZONE_MAIN];
+lights::Light& printDoneLight = lightZones[LIGHT_ZONE_PRINT_DONE];
+lights::Light& stripLight = lightZones[LIGHT_ZONE_STRIP];
+
+lights::LightManager lightManager(lightZones, LIGHT_ZONE_COUNT);
+
+// light patterns (const, so they stay in flash) | {time (ms), level}
+const lights::Keyframe doneKeyframes[] = {{0, 32}, {1500, 255}, {3000, 32}}; // a slow breath
+const lights::Keyframe coolingKeyframes[] = {{0, 0}, {150, 255}, {300, 0}, {450, 255}, {600, 0}, {3000, 0}}; // a double blink every 3 s
+const lights::Keyframe attentionKeyframes[] = {{0, 255}, {250, 255}, {250, 0}, {500, 0}}; // a fast blink
+
+const lights::Pattern donePattern = {doneKeyframes, sizeof(doneKeyframes) / sizeof(doneKeyframes[0])};
+const lights::Pattern coolingPattern = {coolingKeyframes, sizeof(coolingKeyframes) / sizeof(coolingKeyframes[0])};
+const lights::Pattern attentionPattern = {attentionKeyframes, sizeof(attentionKeyframes) / sizeof(attentionKeyframes[0])};
 
 // an instance of the Adafruit_SSD1306 class (the display)
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
+#if DISPLAY_STATS
+// display stats (all in microseconds)
+stats::RollingStat renderTimeStat; // time spent drawing each frame into the buffer
+stats::RollingStat displayTimeStat; // time spent in display.display()
+stats::RollingStat I2CWaitStat; // time spent waiting in useI2C(8) before each push
+stats::RollingStat framePeriodStat; // time between the starts of frames
+#endif
+
+// the temperature history and the graph drawn from it
+graph::History tempHistory;
+graph::Plot tempPlot;
+
 std::vector<String> modeSubs = {"Sb.", "Cd.", "Pr."}; // offset of 1
 std::vector<String> onOffSubs = {"Off", "On"}; // offset of 0, intended for bools
 std::vector<String> yesNoSubs = {"No", "Yes"}; // offset of 0, intended for bools
-std::vector<String> controlModeSubs = {"Temp", "Manl"}; // offset of 1, for the control mode
+#if FAN_HAS_TACH
+menu::baseMenuItem* fanRPMMenuItem = new menu::menuItem<std::atomic<uint16_t>>(&fanRPM, 0, UINT16_MAX, "Fan RPM"); // made read-only by fanSetup()
+#endif
+
+std::vector<String> controlModeSubs = {"Temp", "Manl", "PID", "Tune", "Casc"}; // offset of 1, for the control mode
 
 menu::baseMenuItem* mainMenu[] = {
   new menu::menuItem<std::atomic<uint8_t>>(&mode, MODE_STANDBY, MODE_PRINTING, "Mode", modeSubs, 1),
@@ -141,22 +207,62 @@ menu::baseMenuItem* mainMenu[] = {
   new menu::menuItem<std::atomic<bool>>(&lightSetState, 0, 1, "Lights", onOffSubs),
   new menu::menuItem<std::atomic<bool>>(&printDone, 0, 1, "Print done", yesNoSubs),
   new menu::menuItem<std::atomic<uint8_t>>(&maxFanSpeed, 0, 255, "Max fan speed"),
+  #if FAN_HAS_TACH
+  fanRPMMenuItem,
+  #endif
   new menu::menuItem<std::atomic<bool>>(&lights_On_On_Door_Open, 0, 1, "L. on door open", yesNoSubs),
   new menu::menuItem<std::atomic<uint8_t>>(&menuScrollSpeed, 1, 255, "Scroll speed"),
   new menu::menuItem<std::atomic<uint8_t>>(&nameScrollSpeed, 1, 255, "Name scroll spd"),
-  new menu::menuItem<std::atomic<uint8_t>>(&dimingTime, 1, 255, "M.l. diming spd"),
-  new menu::menuItem<std::atomic<uint8_t>>(&pdl_DimingTime, 1, 255, "Pd.l. dimng spd"),
+  new menu::menuItem<std::atomic<uint16_t>>(&dimingTime, 0, MAX_DIMING_TIME, "M.l. diming ms"),
+  new menu::menuItem<std::atomic<uint16_t>>(&pdl_DimingTime, 0, MAX_DIMING_TIME, "Pd.l. dimng ms"),
+  new menu::menuItem<std::atomic<uint16_t>>(&strip_DimingTime, 0, MAX_DIMING_TIME, "S.l. diming ms"),
+  new menu::menuItem<std::atomic<uint8_t>>(&lightLevel, 0, 255, "M.l. level"),
+  new menu::menuItem<std::atomic<uint8_t>>(&pdl_Level, 0, 255, "Pd.l. level"),
+  new menu::menuItem<std::atomic<uint8_t>>(&strip_Level, 0, 255, "S.l. level"),
+  new menu::menuItem<std::atomic<bool>>(&pdl_Patterns, 0, 1, "Pd.l. patterns", yesNoSubs),
   new menu::menuItem<std::atomic<uint16_t>>(&menuButtonHoldTime, 10, 9999, "Button hld time"),
   new menu::menuItem<std::atomic<uint16_t>>(&screensaverTime, 10, 3600, "Scrensaver time"),
   new menu::menuItem<std::atomic<uint8_t>>(&bigDiff, 1, 99, "Big temp diff"),
   new menu::menuItem<std::atomic<uint8_t>>(&cooldownDif, 1, 99, "Cooldown diff"),
   new menu::menuItem<std::atomic<uint8_t>>(&hysteresis, 0, 99, "Hysterisis"),
-  new menu::menuItem<std::atomic<uint8_t>>(&controlMode, 1, 2, "Control mode", controlModeSubs, 1),
+  new menu::menuItem<std::atomic<uint8_t>>(&controlMode, CONTROL_MODE_TEMP, CONTROL_MODE_CASCADE, "Control mode", controlModeSubs, 1),
+  new menu::menuItem<std::atomic<uint16_t>>(&pidKp, 0, MAX_PID_GAIN, "PID kp"),
+  new menu::menuItem<std::atomic<uint16_t>>(&pidKi, 0, MAX_PID_GAIN, "PID ki"),
+  new menu::menuItem<std::atomic<uint16_t>>(&pidKd, 0, MAX_PID_GAIN, "PID kd"),
+  new menu::menuItem<std::atomic<uint16_t>>(&heaterWindowTime, MIN_HEATER_WINDOW_TIME, 9999, "Htr window ms"),
+  new menu::menuItem<std::atomic<uint16_t>>(&heaterMinOnTime, 0, 9999, "Htr min on ms"),
+  new menu::menuItem<std::atomic<uint16_t>>(&heaterMinOffTime, 0, 9999, "Htr min off ms"),
+  new menu::menuItem<std::atomic<bool>>(&heaterStaging, 0, 1, "Use heater 2", yesNoSubs),
+  new menu::menuItem<std::atomic<uint8_t>>(&stage2Diff, 0, 99, "Stg2 temp diff"),
+  new menu::menuItem<std::atomic<uint8_t>>(&stage2MinRise, 0, 99, "Stg2 min rise"),
+  new menu::menuItem<std::atomic<uint8_t>>(&heaterTempLimit, 20, MAX_HEATER_TEMP - HEATER_TEMP_LIMIT_MARGIN, "Htr temp limit"),
   new menu::menuItem<std::atomic<uint8_t>>(&defaultMaxFanSpeed, 0, 255, "Def max fan spd"),
-  new menu::menuItem<std::atomic<uint16_t>>(&fanKickstartTime, 0, 9999, "Fan kstart time"),
+  new menu::menuItem<std::atomic<uint16_t>>(&fanKickstartTime, 0, FAN_KICKSTART_MAX_TIME, "Fan kstart time"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanMinDuty, 0, 255, "Fan min duty"),
+  #if FAN_HAS_TACH
+  new menu::menuItem<std::atomic<bool>>(&fanLearning, 0, 1, "Learn fan start", yesNoSubs),
+  #endif
   new menu::menuItem<std::atomic<uint8_t>>(&fanOnVal, 0, 255, "Fan on value"),
   new menu::menuItem<std::atomic<uint8_t>>(&fanMidVal, 0, 255, "Fan mid value"),
   new menu::menuItem<std::atomic<uint8_t>>(&fanOffVal, 0, 255, "Fan off value"),
+  new menu::menuItem<std::atomic<uint16_t>>(&fanMaxRPM, 100, 9999, "Fan max RPM"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurvePoints, 2, FAN_CURVE_MAX_POINTS, "Fan crv points"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[0], 0, 99, "Crv1 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[0], 0, 255, "Crv1 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[1], 0, 99, "Crv2 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[1], 0, 255, "Crv2 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[2], 0, 99, "Crv3 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[2], 0, 255, "Crv3 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[3], 0, 99, "Crv4 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[3], 0, 255, "Crv4 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[4], 0, 99, "Crv5 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[4], 0, 255, "Crv5 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[5], 0, 99, "Crv6 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[5], 0, 255, "Crv6 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[6], 0, 99, "Crv7 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[6], 0, 255, "Crv7 airflow"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveErrors[7], 0, 99, "Crv8 temp over"),
+  new menu::menuItem<std::atomic<uint8_t>>(&fanCurveAirflows[7], 0, 255, "Crv8 airflow"),
   new menu::menuItem<std::atomic<uint8_t>>(&servo1Closed, 0, 180, "Servo1 clsd pos"),
   new menu::menuItem<std::atomic<uint8_t>>(&servo2Closed, 0, 180, "Servo2 clsd pos"),
   new menu::menuItem<std::atomic<uint8_t>>(&servo1Open, 0, 180, "Servo1 open pos"),
@@ -166,16 +272,36 @@ menu::baseMenuItem* mainMenu[] = {
   new menu::menuItem<std::atomic<uint8_t>>(&sensorReads, 1, 10, "Sensor reads"),
   new menu::menuItem<std::atomic<uint8_t>>(&sensorReadInterval, 0, 255, "Snsr read intvl"),
   new menu::menuItem<std::atomic<uint16_t>>(&backupInterval, 0, 1800, "Data save intvl"),
-  new menu::menuItem<std::atomic<bool>>(&saveStateOnPowerLoss, 0, 1, "Pwr loss backup", yesNoSubs)
+  new menu::menuItem<std::atomic<bool>>(&saveStateOnPowerLoss, 0, 1, "Pwr loss backup", yesNoSubs),
+  new menu::menuItem<std::atomic<bool>>(&showGraph, 0, 1, "Show graph", yesNoSubs),
+  new menu::menuItem<std::atomic<uint16_t>>(&graphWindow, MIN_GRAPH_WINDOW, MAX_GRAPH_WINDOW, "Graph window")
 };
 
 const uint8_t menuLength = sizeof(mainMenu) / sizeof(mainMenu[0]);
 
 buffers::CircularBuffer I2cBuffer;
 
+outputs::PWMOutput fanOutput(FAN_PIN, FAN_PWM_FREQ, FAN_PWM_BITS, FAN_ON);
+#if FAN_HAS_TACH
+fans::Tachometer fanTach(FAN_TACH_PIN, FAN_TACH_PULSES_PER_REV, FAN_TACH_INTERVAL);
+#endif
+fans::RPMController fanController(FAN_RPM_KP, FAN_RPM_KI);
+
+control::PID temperaturePID(TEMP_FRACTION_BITS, PID_OUTPUT_MAX, PID_DERIVATIVE_FILTER);
+control::RelayAutotune pidAutotune(TEMP_FRACTION_BITS, AUTOTUNE_RELAY_OUTPUT, AUTOTUNE_HYSTERESIS, AUTOTUNE_CYCLES);
+control::PID heaterPID(TEMP_FRACTION_BITS, PID_OUTPUT_MAX, PID_DERIVATIVE_FILTER);
+
+heaters::SlowPWM heater1Output(&heaterWindowTime, &heaterMinOnTime, &heaterMinOffTime, HEATER_DEMAND_MAX);
+heaters::SlowPWM heater2Output(&heaterWindowTime, &heaterMinOnTime, &heaterMinOffTime, HEATER_DEMAND_MAX);
+heaters::Stager heaterStager(TEMP_FRACTION_BITS, HEATER_DEMAND_MAX, STAGE2_RISE_TIME, &stage2Diff, &stage2MinRise);
+repeating_timer_t heaterTimer;
+
 //  set servo variables:
 Servo servo1;
 Servo servo2;
+servos::Trajectory servo1Trajectory;
+servos::Trajectory servo2Trajectory;
+repeating_timer_t servoTimer;
 
 //  set button variables
 Bounce2::Button door_switch = Bounce2::Button();
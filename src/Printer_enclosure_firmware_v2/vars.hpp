@@ -37,6 +37,7 @@
 #include <Bounce2.h> // button library
 
 #include "customLibs.hpp"
+#include "tempGraph.hpp"
 
 //********************************************************************************************************************************************************************************
 
@@ -44,19 +45,21 @@
 
 extern std::atomic<bool> lights_On_On_Door_Open; // controlls if the lights turn on when the door is opened.
 extern std::atomic<bool> saveStateOnPowerLoss;
+extern std::atomic<bool> showGraph; // controlls if the temperature graph is shown instead of the menu
+extern std::atomic<bool> pdl_Patterns; // controlls if the print done light shows patterns instead of just turning on when the print is done
+extern std::atomic<bool> fanLearning; // controlls if the fan's kickstart time and minimum duty cycle are learned from its tachometer | always off without FAN_HAS_TACH
+extern std::atomic<bool> heaterStaging; // controlls if heater 2 is used as a second stage (and the heaters take turns leading)
 
 extern std::atomic<uint8_t> nameScrollSpeed; /// how fast the print name will scroll by (lower is faster, miliseconds per pixel)
 extern std::atomic<uint8_t> menuScrollSpeed; /// how fast the menu will scroll / values will update when either the "up" or "down" button is held
-extern std::atomic<uint8_t> fanOffVal; /// the pwm value used when the fan should be off
-extern std::atomic<uint8_t> fanMidVal; /// the pwm value used when the fan should be halfway on
-extern std::atomic<uint8_t> fanOnVal; /// the pwm value used when the fan should be all the way on
+extern std::atomic<uint8_t> fanOffVal; /// the airflow (fraction of fanMaxRPM) used when the fan should be off
+extern std::atomic<uint8_t> fanMidVal; /// the airflow (fraction of fanMaxRPM) used when the fan should be halfway on
+extern std::atomic<uint8_t> fanOnVal; /// the airflow (fraction of fanMaxRPM) used when the fan should be all the way on
 extern std::atomic<uint8_t> defaultMaxFanSpeed; /// the default maxumum fan speed (what will be used if nothing else is specified)
 extern std::atomic<uint8_t> maxFanSpeed; /// tracks the maximum fan speed alowable
 extern std::atomic<uint8_t> hysteresis; /// the "dead zone" value, the temp can get above or below the target by this much before action is taken
 extern std::atomic<uint8_t> bigDiff; /// the value used to define a large temp difference (in deg. c.)
 extern std::atomic<uint8_t> cooldownDif; /// if the inside and outside temps are within this value of eachother, cooldown() will go to standby()
-extern std::atomic<uint8_t> dimingTime; /// this * 255 = the time (in miliseconds) that togling the lights will take
-extern std::atomic<uint8_t> pdl_DimingTime; /// this * 255 = the time (in miliseconds) that changing the state of the print done light will take
 extern std::atomic<uint8_t> i2cTempSensorRes; /// 0 = 0.5, 1 = 0.25, 2 = 0.125, 3 = 0.625  (higher res takes longer to read)
 extern std::atomic<uint8_t> servo1Open; /// the "open" position for servo 1
 extern std::atomic<uint8_t> servo2Open; /// the "open" position for servo 2
@@ -67,11 +70,32 @@ extern std::atomic<uint8_t> servo2Speed; /// the delay (in miliseconds) in betwe
 extern std::atomic<uint8_t> sensorReadInterval; /// the minimum time (in s) between temp readings
 extern std::atomic<uint8_t> controlMode; /// DEVELOPMENTAL | enclosure control mode (temperature, manual)
 extern std::atomic<uint8_t> sensorReads; /// the number of times the temp sensors will be read each time the temp is goten (the values will be averaged)
+extern std::atomic<uint8_t> lightLevel; /// the brightness of the main lights when on
+extern std::atomic<uint8_t> pdl_Level; /// the brightness of the print done light when on
+extern std::atomic<uint8_t> strip_Level; /// the brightness of the light strip when on
+extern std::atomic<uint8_t> fanMinDuty; /// the lowest duty cycle (0 - 255) the fan is run at once started, so it doesn't stall
+extern std::atomic<uint8_t> stage2Diff; /// how far (deg. c.) the inside temp has to be below the set temp for both heaters to heat
+extern std::atomic<uint8_t> stage2MinRise; /// the slowest one heater can warm the enclosure (in tenths of a deg. c. per minute) before both heat
+extern std::atomic<uint8_t> heaterTempLimit; /// the highest (in deg. c.) the cascade controller will set the heater's target temp to
+extern std::atomic<uint8_t> fanCurvePoints; /// how many of the fan curve's points are used
+extern std::atomic<uint8_t> fanCurveErrors[FAN_CURVE_MAX_POINTS]; /// how far (deg. c.) the inside temp is above the set temp at each point of the fan curve
+extern std::atomic<uint8_t> fanCurveAirflows[FAN_CURVE_MAX_POINTS]; /// the airflow (fraction of fanMaxRPM) at each point of the fan curve
 
 extern std::atomic<uint16_t> backupInterval; // the number of time (in ms) between backups of the menu data
 extern std::atomic<uint16_t> screensaverTime; // how long without user input intil the screensave is displayed (s)
-extern std::atomic<uint16_t> fanKickstartTime; //  the time (in miliseconds) that the fan will be turned on at 100% before being set to its target value
+extern std::atomic<uint16_t> fanKickstartTime; //  the time (in miliseconds) that the fan will be turned on at 100% before being set to its target value | learned if fanLearning is on
 extern std::atomic<uint16_t> menuButtonHoldTime; // how long the "up" or "down" buttons need to be held for to be counted as being held (in miliseconds)
+extern std::atomic<uint16_t> graphWindow; // how much time the temperature graph covers (in minutes)
+extern std::atomic<uint16_t> dimingTime; // the time (in miliseconds) that togling the lights will take
+extern std::atomic<uint16_t> pdl_DimingTime; // the time (in miliseconds) that changing the state of the print done light will take
+extern std::atomic<uint16_t> strip_DimingTime; // the time (in miliseconds) that changing the state of the light strip will take
+extern std::atomic<uint16_t> pidKp; // the PID controller's proportional gain
+extern std::atomic<uint16_t> pidKi; // the PID controller's integral gain
+extern std::atomic<uint16_t> pidKd; // the PID controller's derivative gain
+extern std::atomic<uint16_t> heaterWindowTime; // the time (in miliseconds) a heater's demand is spread over
+extern std::atomic<uint16_t> heaterMinOnTime; // the shortest time (in miliseconds) a heater is turned on for
+extern std::atomic<uint16_t> heaterMinOffTime; // the shortest time (in miliseconds) a heater is turned off for
+extern std::atomic<uint16_t> fanMaxRPM; // the fan's speed (in RPM) at full duty; airflow is a fraction of this
 
 
 
@@ -79,7 +103,7 @@ const String modeStrings[] {"Er.", "Sb.", "Cd.", "Pr."}; // the abreviations for
 const String errorCauses[] {"Unknown / invalid origin", "Temp sensor check", "Invalid mode", "Failure to start temp sensors",
   "Printer commanded error mode", "Invalid command","Temp sensor disconnected", "Serial commanded error",
   "Invalid serial command", "Failure to start PSU", "Failure to start screen", "(Software) watchdog timeout",
-  "Screen disconnected", "Wait for I2C resource timeout", "Invalid parameters passed to function"}; // Plane text explanations of the meaning of different values of errorOrigin
+  "Screen disconnected", "Wait for I2C resource timeout", "Invalid parameters passed to function", "Fan stalled"}; // Plane text explanations of the meaning of different values of errorOrigin
 
 constexpr uint8_t numErrorCauses = sizeof(errorCauses) / sizeof(errorCauses[0]);
 
@@ -101,6 +125,8 @@ extern std::atomic<char> printName[256]; // an array of characters to store the
 
 extern std::atomic<int32_t> errorInfo; // records aditionall info about any posible errors
 
+extern std::atomic<uint32_t> heapAllocations; // counts calls to operator new (only when COUNT_HEAP_ALLOCATIONS is enabled)
+
 extern bool findPressedState; // used during startup to track if the pressed state of the switches and buttons needs to be set
 
 extern bool screensaver; // tracks if the screensaver is active
@@ -122,6 +148,8 @@ extern bool downSw_ps;
 extern std::atomic<bool> PSUIsOn; ///< tracks if the PSU is on
 extern std::atomic<bool> turnLightOff; ///< tracks if the light needs to turn off (only used for printer-commanded changes)
 extern std::atomic<bool> printDone; ///< tracks if the print is done (used to turn on the print done light)
+extern std::atomic<bool> needsAttention; ///< tracks if the printer has asked for someone to come to it (shown by the print done light)
+extern std::atomic<bool> printNameChanged; ///< set whenever the print name is written to, so that core1 knows to re-render it
 extern std::atomic<bool> doorOpen; ///< tracks if the door is open
 extern std::atomic<bool> lightSetState; ///< tracks the state the lights should be in
 extern std::atomic<bool> changeLights; ///< tracks if the lights need to be changed (only used for printer-commanded changes)
@@ -132,6 +160,8 @@ extern std::atomic<bool> coreZeroStartup; ///< tracks if the first core (core0)
 extern std::atomic<bool> coreOneStartup; ///< tracks if the second core (core1) has finished starting up
 
 extern uint8_t targetFanSpeed; ///< the target speed (duty cycle) that the fan will go to
+extern std::atomic<uint16_t> fanRPM; ///< the fan's measured speed | always 0 without FAN_HAS_TACH
+extern bool fanClosedLoop; ///< true if targetFanSpeed is an airflow (set by setAirflow()), false if it is a duty cycle (set by setFan())
 extern uint8_t oldControlMode; ///< tracks the control mode the enclosure was in last loop
 extern uint8_t oldMode; ///< tracks the mode the enclosure was in last loop
 extern std::atomic<uint8_t> mode; ///< tracks the enclosures operating mode (0 = error, 1 = standby, 2 = cooldown, 3 = printing)
@@ -139,18 +169,21 @@ extern std::atomic<uint8_t> globalSetTemp; ///< tracks what temperature the encl
 extern volatile uint8_t errorOrigin; /* records where an error originated (usefull for diagnostics)
 (0 = N/A, 1 = Heater check failure, 2 = unrecognised mode, 3 = failure to start I2C temp sensors, 4 = printer commanded error, 5 = invalid printer command,
 6 = sensors disconnected, 7 = serial commanded error, 8 = invalid serial command, 9 = failure to start PSU in allocated time, 10 = failure to start screen,
-11 = (software) watchdog timeout, 12 = screen disconnected, 13 = wait for I2C timeout, 14 = invalid parameters passed to function)*/
+11 = (software) watchdog timeout, 12 = screen disconnected, 13 = wait for I2C timeout, 14 = invalid parameters passed to function, 15 = fan stalled)*/
 
-extern uint8_t servo1SetPos; /// the target position for servo 1
-extern uint8_t servo2SetPos; /// the target position for servo 2
+extern uint8_t ventState; /// VENT_CLOSED, VENT_OPENING, VENT_OPEN, or VENT_CLOSING
+extern bool ventOpenRequested; /// true if the vent should be open (set by setVent())
 
 extern int16_t heaterTemp; /// tracks the heater temp
+extern int16_t heaterTempFine; /// tracks the heater temp, with TEMP_FRACTION_BITS fractional bits
 extern int16_t inTemp; /// tracks the temp inside the enclosure
+extern int16_t inTempFine; /// tracks the temp inside the enclosure, with TEMP_FRACTION_BITS fractional bits
 extern int16_t outTemp; /// tracks the temp outside the enclosure
 
 extern uint32_t lastUserInput; /// tracks when the last user input was
 
 extern uint32_t core1Time; /// updated each loop of core1, keeps track of the time for that loop
+extern uint32_t tempReadTime; /// when (ms) the temps were last read
 
 namespace menu {
   extern uint8_t topDisplayMenuItem; /// the meu item to be displayed at the top of the visible portion of the screen
@@ -161,12 +194,32 @@ namespace menu {
 }
 
 // lights
-extern lights::Light printDoneLight;
-extern lights::Light mainLight;
+extern lights::Light lightZones[LIGHT_ZONE_COUNT]; /// every light, indexed by LIGHT_ZONE_*
+extern lights::Light& mainLight;
+extern lights::Light& printDoneLight;
+extern lights::Light& stripLight;
+extern lights::LightManager lightManager;
+
+// light patterns
+extern const lights::Pattern donePattern; ///< the print is done
+extern const lights::Pattern coolingPattern; ///< the enclosure is cooling down
+extern const lights::Pattern attentionPattern; ///< the printer needs attention
 
 // screen
 extern Adafruit_SSD1306 display;
 
+#if DISPLAY_STATS
+// display stats (all in microseconds)
+extern stats::RollingStat renderTimeStat;
+extern stats::RollingStat displayTimeStat;
+extern stats::RollingStat I2CWaitStat;
+extern stats::RollingStat framePeriodStat;
+#endif
+
+// temperature graph
+extern graph::History tempHistory;
+extern graph::Plot tempPlot;
+
 // main menu
 extern menu::baseMenuItem* mainMenu[];
 
@@ -175,9 +228,33 @@ extern const uint8_t menuLength; /// the length of the menu (the number of items
 // buffers
 extern buffers::CircularBuffer I2cBuffer;
 
+// fan
+extern outputs::PWMOutput fanOutput; /// the fan's PWM pin (FAN_PWM_FREQ, FAN_PWM_BITS, FAN_ON polarity)
+#if FAN_HAS_TACH
+extern fans::Tachometer fanTach;
+#endif
+extern fans::RPMController fanController;
+#if FAN_HAS_TACH
+extern menu::baseMenuItem* fanRPMMenuItem; /// read-only
+#endif
+
+// temperature control
+extern control::PID temperaturePID; /// the controller for CONTROL_MODE_PID
+extern control::RelayAutotune pidAutotune; /// finds temperaturePID's gains in CONTROL_MODE_AUTOTUNE
+extern control::PID heaterPID; /// the inner (heater temp) controller for CONTROL_MODE_CASCADE | temperaturePID is the outer one
+
+// heaters
+extern heaters::SlowPWM heater1Output; /// time-proportions heater 1's demand
+extern heaters::SlowPWM heater2Output; /// time-proportions heater 2's demand
+extern heaters::Stager heaterStager; /// decides when both heaters should heat
+extern repeating_timer_t heaterTimer; ///< calls heaterTick() every HEATER_TICK_INTERVAL ms
+
 // servos
 extern Servo servo1;
 extern Servo servo2;
+extern servos::Trajectory servo1Trajectory;
+extern servos::Trajectory servo2Trajectory;
+extern repeating_timer_t servoTimer; ///< calls servoTick() every SERVO_TICK_INTERVAL ms
 
 // buttons
 extern Bounce2::Button door_switch;
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// builds the real screen code (menuFuncs.cpp, textRenderer.cpp, tempGraph.cpp) on a computer and draws a set of frames with it
+// each frame goes through the stand-in Adafruit_SSD1306 and Wire, and is decoded by a model of the panel; what the panel shows is compared with a golden PBM image
+// it also counts the bytes that went over I2C for each frame, and times how long drawing a frame takes (on the computer, not the RP2040)
+// set UPDATE_GOLDEN=1 to (re)write the golden images instead of comparing against them
+
+#include "menuFuncs.hpp"
+#include "vars.hpp"
+#include "ssd1306Panel.hpp"
+#include "../testUtils.hpp"
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+extern uint32_t fakeErrors;
+
+namespace {
+  constexpr int TIMING_FRAMES = 2000; ///< how many times each frame is drawn to time it
+
+  SSD1306Panel panel;
+
+  /// moves the fake clock forward, the same way loop1() keeps core1Time up to date
+  void wait(uint32_t ms) {
+    hostStubs::advanceMicros(static_cast<uint64_t>(ms) * 1000);
+    core1Time = millis();
+  }
+
+  void setPrintName(const char* name) {
+    size_t length = strlen(name);
+    for (size_t i = 0; i < 256; i++) printName[i] = (i < length) ? name[i] : '\0';
+    printNameChanged = true;
+  }
+
+  /// the drawing part of updateScreen() (what renderTime covers on the RP2040)
+  void render() {
+    display.clearDisplay();
+
+    if (showGraph) {
+      printHeader();
+      printGraph();
+
+    } else {
+      printMenuPage();
+    }
+  }
+
+  /// the average time it takes to draw the current frame, in microseconds
+  double timeRender() {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TIMING_FRAMES; i++) render();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / TIMING_FRAMES;
+  }
+
+  /// what the panel is showing, as a PBM image (lit pixels are white, like the screen)
+  std::string panelImage() {
+    std::string image = "P4\n128 64\n";
+
+    for (uint8_t y = 0; y < 64; y++) {
+      uint8_t row[16] = {0};
+      for (uint8_t x = 0; x < 128; x++) {
+        if (!((panel.gram[y >> 3][x] >> (y & 7)) & 1)) row[x >> 3] |= 0x80 >> (x & 7);
+      }
+      image.append(reinterpret_cast<const char*>(row), sizeof(row));
+    }
+
+    return image;
+  }
+
+  void checkGolden(const char* name) {
+    std::string image = panelImage();
+    std::string goldenPath = std::string(GOLDEN_DIR) + "/" + name + ".pbm";
+    const char* update = getenv("UPDATE_GOLDEN");
+
+    std::ifstream goldenFile(goldenPath, std::ios::binary);
+    if (!goldenFile || ((update != nullptr) && (update[0] == '1'))) {
+      std::ofstream(goldenPath, std::ios::binary) << image;
+      printf("wrote %s\n", goldenPath.c_str());
+      return;
+    }
+
+    std::string golden((std::istreambuf_iterator<char>(goldenFile)), std::istreambuf_iterator<char>());
+    if (golden != image) {
+      std::string actualPath = std::string(name) + ".actual.pbm";
+      std::ofstream(actualPath, std::ios::binary) << image;
+      printf("%s doesn't match %s (wrote what the panel showed to %s)\n", name, goldenPath.c_str(), actualPath.c_str());
+    }
+    CHECK(golden == image);
+  }
+
+  /// sends one full frame, checks it, and prints its cost
+  void frame(const char* name) {
+    Wire.resetCounts();
+    uint32_t startData = panel.dataBytes;
+
+    updateScreen();
+
+    uint32_t busBytes = Wire.busBytes;
+    uint32_t writes = Wire.transmissions;
+
+    CHECK(panel.on);
+    CHECK((panel.dataBytes - startData) == sizeof(panel.gram)); // the whole frame reached the panel
+    CHECK(memcmp(panel.gram, display.getBuffer(), sizeof(panel.gram)) == 0); // and landed where it was drawn
+    checkGolden(name);
+
+    double renderTime = timeRender();
+    CHECK(memcmp(panel.gram, display.getBuffer(), sizeof(panel.gram)) == 0); // drawing it again gives the same frame
+
+    printf("%-16s %7.2f us to draw, %5lu bytes over I2C in %lu writes\n", name, renderTime, static_cast<unsigned long>(busBytes), static_cast<unsigned long>(writes));
+  }
+
+  void screensaverFrames() {
+    mode = MODE_STANDBY;
+    showGraph = false;
+    frame("standby_wake");
+
+    uint8_t lastFrame[8][128];
+    memcpy(lastFrame, panel.gram, sizeof(lastFrame));
+
+    wait(screensaverTime * 1000 + 1);
+    Wire.resetCounts();
+    updateScreen(); // dims the screen
+    printf("%-16s %5lu bytes over I2C\n", "screensaver_dim", static_cast<unsigned long>(Wire.busBytes));
+    CHECK(panel.on);
+    CHECK(panel.contrast == SCREENSAVER_CONTRAST);
+    CHECK(Wire.busBytes <= 6); // two commands
+    CHECK(memcmp(lastFrame, panel.gram, sizeof(lastFrame)) == 0); // the last frame stays up
+
+    wait(1000);
+    Wire.resetCounts();
+    updateScreen();
+    CHECK(Wire.busBytes == 0); // nothing is sent while the screen is dimmed
+
+    wait(SCREENSAVER_OFF_TIME * 1000);
+    Wire.resetCounts();
+    updateScreen(); // turns the screen off
+    printf("%-16s %5lu bytes over I2C\n", "screensaver_off", static_cast<unsigned long>(Wire.busBytes));
+    CHECK(!panel.on);
+    CHECK(Wire.busBytes <= 3); // one command
+
+    lastUserInput = core1Time;
+    frame("standby_wake");
+    CHECK(panel.contrast == Adafruit_SSD1306::NORMAL_CONTRAST);
+  }
+}
+
+int main() {
+  Wire.listener = [](uint8_t address, const std::vector<uint8_t>& bytes) { panel.receive(address, bytes); };
+
+  wait(1000);
+  lastUserInput = core1Time;
+  wakeScreen(); // the panel as setup() leaves it: on, at normal contrast
+
+  mode = MODE_STANDBY;
+  inTemp = 23;
+  outTemp = 21;
+  frame("standby_menu");
+
+  mode = MODE_PRINTING;
+  inTemp = 38;
+  globalSetTemp = 45;
+  setPrintName("benchy.gcode");
+  frame("printing_name");
+
+  // edit the second menu item (one step up), then put it back
+  menu::selectedItem = 1;
+  sell_switch_Pressed();
+  up_switch_Pressed();
+  frame("editing_item");
+  down_switch_Pressed();
+  sell_switch_Pressed();
+  menu::selectedItem = 0;
+
+  // a name too long for the screen scrolls one pixel every nameScrollSpeed ms
+  setPrintName("a_very_long_print_name_for_the_enclosure.gcode");
+  frame("long_name_start");
+  for (uint8_t i = 0; i < 40; i++) {
+    wait(nameScrollSpeed);
+    updateScreen();
+  }
+  frame("long_name_scroll");
+
+  // an hour of a print heating up, then the graph page
+  for (uint32_t s = 0; s < 3600; s++) {
+    wait(1000);
+    int16_t in = 22 + static_cast<int16_t>(min(s / 100, static_cast<uint32_t>(23)));
+    tempHistory.tick(core1Time, in, 21, in + 15, 45);
+  }
+  lastUserInput = core1Time;
+  mode = MODE_PRINTING;
+  inTemp = 45;
+  showGraph = true;
+  frame("graph");
+
+  setPrintName("");
+  screensaverFrames();
+
+  CHECK(fakeErrors == 0);
+
+  return testUtils::finish("displayHarness");
+}
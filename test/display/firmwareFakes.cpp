@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// the firmware functions menuFuncs.cpp calls that live in files the display harness doesn't build
+
+#include "otherFuncs.hpp"
+#include <cstdio>
+
+uint32_t fakeErrors = 0; ///< how many times setError() was called | the harness fails if this isn't 0
+
+void setError(uint8_t origin, uint32_t info, bool recoverable) {
+  fakeErrors++;
+  printf("setError(%u, %u, %u) called\n", origin, static_cast<unsigned>(info), recoverable);
+}
+
+bool useI2C(uint16_t) {
+  return true; // there is only one thread, so the bus is always free
+}
+
+bool useI2C(uint16_t, uint16_t) {
+  return true;
+}
+
+void doneWithI2C() {}
+
+void fixFanCurve() {} // the harness never edits a menu item
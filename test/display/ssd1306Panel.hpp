@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// a model of the SSD1306 itself: decodes the I2C writes sent to it into commands and display RAM, so tests can see what the panel would actually show
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class SSD1306Panel {
+  public:
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t PAGES = 8;
+
+    uint8_t gram[PAGES][WIDTH] = {}; ///< the display RAM, page-organized like the frame buffer
+    uint8_t contrast = 0x7F; ///< the contrast after reset
+    bool on = false; ///< the panel starts off after reset
+    uint32_t commandCount = 0; ///< commands received (not counting their arguments)
+    uint32_t dataBytes = 0; ///< bytes written to the display RAM
+
+    /// pass each finished I2C write here (TwoWire::listener)
+    void receive(uint8_t address, const std::vector<uint8_t>& bytes) {
+      if ((address != 0x3C) || bytes.empty()) return;
+
+      bool data = (bytes[0] & 0x40) != 0; // the control byte: 0x00 for commands, 0x40 for data (no continuation bit is used)
+
+      for (size_t i = 1; i < bytes.size(); i++) {
+        if (data) writeData(bytes[i]);
+        else writeCommand(bytes[i]);
+      }
+    }
+
+  private:
+    uint8_t panel_columnStart = 0, panel_columnEnd = WIDTH - 1;
+    uint8_t panel_pageStart = 0, panel_pageEnd = PAGES - 1;
+    uint8_t panel_column = 0, panel_page = 0;
+    uint8_t panel_command = 0; ///< the command waiting for arguments
+    uint8_t panel_argsNeeded = 0;
+    uint8_t panel_args[6] = {};
+    uint8_t panel_argCount = 0;
+
+    static uint8_t argsFor(uint8_t command) {
+      switch (command) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+        case 0x21: case 0x22: case 0xA3: return 2;
+        case 0x29: case 0x2A: return 5;
+        case 0x26: case 0x27: return 6;
+        default: return 0;
+      }
+    }
+
+    void writeCommand(uint8_t byte) {
+      if (panel_argsNeeded > 0) { // an argument for the last command (they can arrive in a later write)
+        panel_args[panel_argCount++] = byte;
+        if (--panel_argsNeeded == 0) runCommand();
+        return;
+      }
+
+      commandCount++;
+      panel_command = byte;
+      panel_argCount = 0;
+      panel_argsNeeded = argsFor(byte);
+      if (panel_argsNeeded == 0) runCommand();
+    }
+
+    void runCommand() {
+      switch (panel_command) {
+        case 0x21: // column address
+          panel_columnStart = panel_args[0] & 0x7F;
+          panel_columnEnd = panel_args[1] & 0x7F;
+          panel_column = panel_columnStart;
+          break;
+        case 0x22: // page address
+          panel_pageStart = panel_args[0] & 0x07;
+          panel_pageEnd = panel_args[1] & 0x07;
+          panel_page = panel_pageStart;
+          break;
+        case 0x81: contrast = panel_args[0]; break;
+        case 0xAE: on = false; break;
+        case 0xAF: on = true; break;
+        default: break; // nothing else changes what the tests look at
+      }
+    }
+
+    /// horizontal addressing mode, which is what the library sets up
+    void writeData(uint8_t byte) {
+      dataBytes++;
+      gram[panel_page][panel_column] = byte;
+
+      if (panel_column++ >= panel_columnEnd) {
+        panel_column = panel_columnStart;
+        if (panel_page++ >= panel_pageEnd) panel_page = panel_pageStart;
+      }
+    }
+};
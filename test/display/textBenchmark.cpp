@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// times drawing the same frame's text two ways: the way it used to be drawn (Adafruit_GFX's print(), one pixel at a time) and with textRenderer (a byte-wide column at a time)
+// both have to give exactly the same pixels; the times are for the computer the test runs on, not the RP2040, so only the ratio between them means much
+
+#include "textRenderer.hpp"
+#include <Adafruit_SSD1306.h>
+#include "../testUtils.hpp"
+#include <chrono>
+
+namespace {
+  constexpr int FRAMES = 20000; ///< how many times each way of drawing the frame is timed
+
+  Adafruit_SSD1306 screen(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+
+  /// one line of text on the test frame
+  struct Line {
+    int16_t x;
+    int16_t y;
+    const char* text;
+    uint8_t size;
+    bool invert;
+  };
+
+  /// the header and a page of menu items while printing, with one item being edited
+  constexpr Line frameLines[] = {
+    {0, 0, "Printing", 2, false},
+    {62, 0, "38/45", 2, false},
+    {122, 0, "o", 1, false},
+    {0, 16, " Print done light", 1, false},
+    {104, 16, "Yes", 1, false},
+    {0, 26, ">Set temp", 1, true},
+    {104, 26, "45", 1, true},
+    {0, 36, " Fan max speed", 1, false},
+    {104, 36, "255", 1, false},
+    {0, 46, " Scrensaver time", 1, false},
+    {104, 46, "15", 1, false},
+    {0, 56, " Graph window", 1, false},
+    {104, 56, "60", 1, false},
+  };
+
+  /// the highlight behind the item being edited (drawn the same way both times)
+  void drawHighlight() {
+    screen.fillRect(0, 25, SCREEN_WIDTH, CHARACTER_HEIGHT + 1, SSD1306_WHITE);
+  }
+
+  void drawWithGFX() {
+    screen.clearDisplay();
+    drawHighlight();
+
+    for (const Line& line : frameLines) {
+      screen.setTextSize(line.size);
+      screen.setTextColor(line.invert ? SSD1306_BLACK : SSD1306_WHITE, line.invert ? SSD1306_WHITE : SSD1306_BLACK);
+      screen.setCursor(line.x, line.y);
+      screen.print(line.text);
+    }
+  }
+
+  void drawWithTextRenderer() {
+    screen.clearDisplay();
+    drawHighlight();
+
+    for (const Line& line : frameLines) {
+      text::drawString(screen.getBuffer(), line.x, line.y, line.text, line.size, line.invert);
+    }
+  }
+
+  /// the average time it takes to draw the frame, in microseconds
+  double timeFrame(void (*draw)()) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; i++) draw();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / FRAMES;
+  }
+
+  /// copies the font out of textRenderer (one character at a time) into the stand-in Adafruit_GFX, as the two use the same one
+  void loadFont() {
+    for (int c = ' '; c <= '~'; c++) {
+      screen.clearDisplay();
+      text::drawChar(screen.getBuffer(), 0, 0, static_cast<char>(c), 1, false);
+      memcpy(&Adafruit_GFX::font[c * 5], screen.getBuffer(), 5);
+    }
+  }
+}
+
+int main() {
+  loadFont();
+
+  uint8_t gfxFrame[(SCREEN_WIDTH * SCREEN_HEIGHT) / 8];
+  drawWithGFX();
+  memcpy(gfxFrame, screen.getBuffer(), sizeof(gfxFrame));
+
+  drawWithTextRenderer();
+  CHECK(memcmp(gfxFrame, screen.getBuffer(), sizeof(gfxFrame)) == 0); // both draw exactly the same pixels
+
+  double gfxTime = timeFrame(drawWithGFX);
+  double rendererTime = timeFrame(drawWithTextRenderer);
+
+  printf("Adafruit_GFX print(): %7.2f us per frame\n", gfxTime);
+  printf("textRenderer:         %7.2f us per frame (%.1fx faster)\n", rendererTime, gfxTime / rendererTime);
+
+  return testUtils::finish("textBenchmark");
+}
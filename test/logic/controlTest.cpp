@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// tests for the temperature control logic: relay autotuning, then the PID controller with the gains it found, run against a model of the enclosure and its heater
+
+#include "logicLibs.hpp"
+#include "../testUtils.hpp"
+#include <cmath>
+#include <deque>
+
+using namespace control;
+
+namespace {
+  constexpr uint8_t FRACTION_BITS = 3; ///< TEMP_FRACTION_BITS
+  constexpr int16_t OUTPUT_MAX = 1000; ///< PID_OUTPUT_MAX
+  constexpr uint32_t READ_INTERVAL = 10; ///< DEFAULT_SENSOR_READ_INTERVAL (s)
+  constexpr int16_t SET_TEMP = 45 << FRACTION_BITS;
+
+  /// the enclosure as a first order plus dead time system: the air heads for ambient + gain * output with a 15 minute time constant, a minute after the output changes | cooling (a negative output) runs the fan, which speeds up the heat loss instead
+  struct Enclosure {
+    double temp = 25; ///< deg. c.
+    std::deque<int16_t> pending = std::deque<int16_t>(60, 0); ///< the outputs still on their way (one per second), for the dead time
+
+    static constexpr double AMBIENT = 25;
+    static constexpr double GAIN = 0.04; ///< deg. c. over ambient per unit of output (so full heat holds 65 deg. c.)
+    static constexpr double TIME_CONSTANT = 900; ///< s
+    static constexpr double FAN_BOOST = 2; ///< full cooling loses heat this many times faster again
+
+    /// runs for one second
+    void run(int16_t output) {
+      pending.push_back(output);
+      int16_t acting = pending.front();
+      pending.pop_front();
+
+      double target = AMBIENT + (GAIN * std::max<int16_t>(acting, 0));
+      double rate = 1 + ((FAN_BOOST * std::max<int16_t>(-acting, 0)) / OUTPUT_MAX);
+      temp += ((target - temp) * rate) / TIME_CONSTANT;
+    }
+
+    /// what the sensor reads, like inTempFine (rounded down to an eighth of a degree)
+    int16_t read() const {
+      return static_cast<int16_t>(std::floor(temp * (1 << FRACTION_BITS)));
+    }
+  };
+
+  /// the results of heating the enclosure from ambient to SET_TEMP
+  struct Response {
+    double peak = 0; ///< the hottest it got (deg. c.)
+    double worstSettled = 0; ///< the furthest it was from the set temp over the last hour (deg. c.)
+  };
+
+  /// heats the enclosure from ambient for three hours, with <control> given each new reading and returning the output
+  template <typename Control>
+  Response heatUp(Control control) {
+    Enclosure enclosure;
+    Response response;
+    int16_t output = 0;
+
+    for (uint32_t second = 0; second < 3 * 3600; second++) {
+      if (second % READ_INTERVAL == 0) output = control(enclosure.read());
+      enclosure.run(output);
+
+      response.peak = std::max(response.peak, enclosure.temp);
+      if (second >= 2 * 3600) response.worstSettled = std::max(response.worstSettled, std::fabs(enclosure.temp - (SET_TEMP >> FRACTION_BITS)));
+    }
+
+    return response;
+  }
+
+  /// runs a relay autotune on the enclosure (as CONTROL_MODE_AUTOTUNE does), and returns the gains it found
+  bool autotune(uint16_t& kp, uint16_t& ki, uint16_t& kd) {
+    Enclosure enclosure;
+    RelayAutotune tune(FRACTION_BITS, 1000, 2, 4); // AUTOTUNE_RELAY_OUTPUT, AUTOTUNE_HYSTERESIS, AUTOTUNE_CYCLES
+    tune.start(SET_TEMP, enclosure.read());
+    int16_t output = tune.getOutput();
+
+    for (uint32_t second = 0; second < 14400 && !tune.isDone(); second++) { // AUTOTUNE_TIMEOUT
+      if (second % READ_INTERVAL == 0) output = tune.update(enclosure.read(), second * 1000);
+      enclosure.run(output);
+    }
+
+    CHECK(tune.isDone());
+    return tune.getGains(kp, ki, kd);
+  }
+
+  void tunedPID() {
+    uint16_t kp, ki, kd;
+    CHECK(autotune(kp, ki, kd));
+    CHECK(kp > 0 && ki > 0 && kd > 0);
+
+    PID pid(FRACTION_BITS, OUTPUT_MAX, 4); // PID_DERIVATIVE_FILTER
+    pid.setGains(kp, ki, kd);
+    Response tuned = heatUp([&](int16_t measured) { return pid.update(SET_TEMP, measured, READ_INTERVAL * 1000); });
+
+    // what CONTROL_MODE_TEMP does while heating: full heat until the (whole degree) temp is over the set temp, then nothing until it is a degree under
+    bool heating = true;
+    Response bangBang = heatUp([&](int16_t measured) {
+      int16_t degrees = measured >> FRACTION_BITS;
+      if (degrees + 1 < (SET_TEMP >> FRACTION_BITS)) heating = true;
+      else if (degrees > (SET_TEMP >> FRACTION_BITS)) heating = false;
+      return static_cast<int16_t>(heating ? OUTPUT_MAX : 0);
+    });
+
+    CHECK(tuned.peak < (SET_TEMP >> FRACTION_BITS) + 0.5); // overshoots less than half a degree
+    CHECK(tuned.worstSettled < 0.25); // and holds within a quarter of a degree
+    CHECK(bangBang.peak - (SET_TEMP >> FRACTION_BITS) > 3 * (tuned.peak - (SET_TEMP >> FRACTION_BITS))); // a fraction of the bang-bang control's overshoot
+    CHECK(bangBang.worstSettled > tuned.worstSettled);
+  }
+
+  void reachesFullOutput() {
+    PID pid(FRACTION_BITS, OUTPUT_MAX, 1);
+    pid.setGains(100, 100, 0);
+
+    int16_t output = 0;
+    for (int i = 0; i < 200; i++) output = pid.update(SET_TEMP, SET_TEMP - 8, 10000); // a degree under for 2000 s
+    CHECK(output == OUTPUT_MAX); // the integral gets the output all the way to the limit
+
+    int16_t first = pid.update(SET_TEMP, SET_TEMP + 8, 10000); // but no further, so it comes back down as soon as the temp is over
+    CHECK(first < OUTPUT_MAX);
+  }
+
+  void noKick() {
+    PID pid(FRACTION_BITS, OUTPUT_MAX, 1);
+    pid.setGains(100, 0, 500);
+    pid.update(SET_TEMP, SET_TEMP, 10000);
+    CHECK(pid.update(SET_TEMP + 80, SET_TEMP, 10000) == 1000); // a new setpoint moves the proportional term
+    CHECK(pid.update(SET_TEMP + 8, SET_TEMP, 10000) == 100); // but not the derivative, which only sees the measurement
+  }
+}
+
+int main() {
+  tunedPID();
+  reachesFullOutput();
+  noKick();
+
+  return testUtils::finish("controlTest");
+}
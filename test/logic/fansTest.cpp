@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// tests for the fan speed logic: tachometer pulses to RPM, and the PI speed controller, run against a model of a fan
+
+#include "logicLibs.hpp"
+#include "../testUtils.hpp"
+#include <cmath>
+#include <cstdlib>
+
+using namespace fans;
+
+namespace {
+  constexpr uint16_t KP = 16; ///< FAN_RPM_KP
+  constexpr uint16_t KI = 4; ///< FAN_RPM_KI
+  constexpr uint32_t INTERVAL = 500; ///< FAN_TACH_INTERVAL (ms)
+  constexpr uint8_t PULSES_PER_REV = 2;
+  constexpr uint16_t MAX_RPM = 3000;
+
+  /// a PC fan: doesn't turn below 20% duty, and (like most) runs faster than proportional to duty above that; speed follows with a 1 s lag
+  struct FanModel {
+    double rpm = 0;
+    double pulses = 0; ///< tachometer pulses not counted yet (fractions carry over)
+
+    static double steadyRPM(uint16_t duty) {
+      double fraction = duty / 65535.0;
+      if (fraction < 0.2) return 0;
+      return MAX_RPM * (0.4 + (0.6 * (fraction - 0.2) / 0.8));
+    }
+
+    /// runs the fan for one tachometer interval, and returns the RPM the tachometer would read
+    uint16_t run(uint16_t duty) {
+      double target = steadyRPM(duty);
+      for (uint32_t ms = 0; ms < INTERVAL; ms++) {
+        rpm += (target - rpm) / 1000.0;
+        pulses += (rpm * PULSES_PER_REV) / 60000.0;
+      }
+
+      uint32_t counted = static_cast<uint32_t>(pulses);
+      pulses -= counted;
+      return pulsesToRPM(counted, INTERVAL * 1000, PULSES_PER_REV);
+    }
+  };
+
+  void conversion() {
+    CHECK(pulsesToRPM(50, 500000, 2) == 3000);
+    CHECK(pulsesToRPM(1, 500000, 2) == 60); // the resolution at the default interval
+    CHECK(pulsesToRPM(0, 500000, 2) == 0);
+    CHECK(pulsesToRPM(10, 0, 2) == 0);
+    CHECK(pulsesToRPM(10, 500000, 0) == 0);
+    CHECK(pulsesToRPM(UINT32_MAX, 1, 1) == UINT16_MAX);
+  }
+
+  void runningSpeeds() {
+    CHECK(runningSpeed(1500, 3000, 300) == 1500);
+    CHECK(runningSpeed(188, 3000, 300) == 300); // too slow to keep turning, so raised to the floor
+    CHECK(runningSpeed(2400, 1500, 300) == 1500); // capped
+    CHECK(runningSpeed(0, 3000, 300) == 0); // off stays off
+    CHECK(runningSpeed(188, 200, 300) == 0); // it can't turn slowly enough to stay under the cap, so it is left off
+    CHECK(runningSpeed(100, 0, 0) == 0); // a cap of 0 is off, even with no floor
+    CHECK(runningSpeed(40, 60, 64) == 0); // a learned minimum duty doesn't override the max fan speed
+    CHECK(runningSpeed(200, 100, 64) == 100);
+  }
+
+  void lowestAirflows() {
+    CHECK(lowestAirflow(300, 3000) == 26); // 25.5, rounded up
+    CHECK(lowestAirflow(300, 2550) == 30);
+    CHECK(((static_cast<uint32_t>(lowestAirflow(200, 3000)) * 3000) / 255) >= 200); // the old default's lowest point (16) ran the fan at 188 RPM
+    CHECK(lowestAirflow(300, 100) == 255); // the fan can't go that fast
+    CHECK(lowestAirflow(300, 0) == 255);
+  }
+
+  void openLoopFallback() {
+    SpeedPlan plan = planSpeed(128, 255, true, true, 3000, 300, 64);
+    CHECK(plan.closedLoop && plan.speed == 1505); // an airflow is held as a speed once the fan's speed is known
+
+    plan = planSpeed(128, 255, true, false, 3000, 300, 64);
+    CHECK(!plan.closedLoop && plan.speed == 128); // without a tachometer (or before it has shown the fan turning) it is a duty cycle instead
+    CHECK((plan.speed * 257) < UINT16_MAX); // so the fan isn't run flat out, like a closed loop reading 0 RPM would
+
+    plan = planSpeed(16, 255, true, false, 3000, 300, 64);
+    CHECK(!plan.closedLoop && plan.speed == 64); // raised to the minimum duty, not FAN_MIN_RPM
+
+    plan = planSpeed(200, 100, true, false, 3000, 300, 64);
+    CHECK(!plan.closedLoop && plan.speed == 100); // still capped
+
+    plan = planSpeed(0, 255, true, false, 3000, 300, 64);
+    CHECK(plan.speed == 0);
+
+    plan = planSpeed(128, 255, false, true, 3000, 300, 64);
+    CHECK(!plan.closedLoop && plan.speed == 128); // a duty cycle is never held as a speed
+
+    // the open loop fallback doesn't wind up while the fan reads 0 RPM, unlike the controller
+    RPMController controller(KP, KI);
+    uint16_t duty = 0;
+    for (uint8_t i = 0; i < 50; i++) duty = controller.update(1505, 0, MAX_RPM, 64);
+    CHECK(duty == UINT16_MAX);
+  }
+
+  /// runs the controller and the fan for <updates> tachometer intervals, and returns the last reading
+  uint16_t settle(RPMController& controller, FanModel& fan, uint16_t target, uint8_t minDuty, uint16_t updates, uint16_t& measured, uint16_t& duty) {
+    for (uint16_t i = 0; i < updates; i++) {
+      duty = controller.update(target, measured, MAX_RPM, minDuty);
+      measured = fan.run(duty);
+    }
+    return measured;
+  }
+
+  void holdsSpeed() {
+    RPMController controller(KP, KI);
+    FanModel fan;
+    uint16_t measured = 0;
+    uint16_t duty = 0;
+
+    // the fan runs faster than the feed-forward guess expects, so only the integral gets it right
+    CHECK_NEAR(settle(controller, fan, 1500, 0, 60, measured, duty), 1500, 90);
+    CHECK(duty < ((1500 * 65535) / MAX_RPM)); // less than proportional
+
+    // what the integral learned carries over to a new target
+    uint16_t before = measured;
+    settle(controller, fan, 2400, 0, 20, measured, duty);
+    CHECK(measured > before);
+    CHECK_NEAR(settle(controller, fan, 2400, 0, 40, measured, duty), 2400, 90);
+
+    CHECK(controller.update(0, measured, MAX_RPM, 0) == 0); // 0 is off
+    CHECK(controller.update(1000, measured, 0, 0) == 0); // so is an unknown maximum speed
+  }
+
+  void minimumDuty() {
+    RPMController controller(KP, KI);
+    uint16_t duty = controller.update(300, 3000, MAX_RPM, 100); // far too fast, so the output wants to be 0
+    CHECK(duty == ((100 * 257 * 256) >> 8)); // but it is held at the minimum duty
+  }
+
+  /// starts a fan from rest with a controller, and returns the highest speed it reaches (after the first few readings) | <measured> is left at the last reading
+  uint16_t startPeak(RPMController& controller, uint16_t& measured) {
+    FanModel fan;
+    uint16_t peak = 0;
+    measured = 0;
+
+    for (int i = 0; i < 60; i++) {
+      measured = fan.run(controller.update(1500, measured, MAX_RPM, 0));
+      if (i > 4) peak = std::max(peak, measured);
+    }
+
+    return peak;
+  }
+
+  void noWindup() {
+    RPMController fresh(KP, KI);
+    uint16_t freshMeasured;
+    uint16_t freshPeak = startPeak(fresh, freshMeasured);
+    CHECK_NEAR(freshMeasured, 1500, 90);
+
+    RPMController stalled(KP, KI);
+    uint16_t duty = 0;
+    for (int i = 0; i < 100; i++) duty = stalled.update(1500, 0, MAX_RPM, 0); // stalled (held) for 50 s
+    CHECK(duty == 65535); // the output still gets all the way to full
+
+    // once the fan is free, it should overshoot no more than a fresh start does (the integral didn't wind up while it was stalled)
+    uint16_t measured;
+    uint16_t peak = startPeak(stalled, measured);
+    CHECK(peak <= freshPeak + 120);
+    CHECK_NEAR(measured, 1500, 90);
+  }
+}
+
+int main() {
+  conversion();
+  runningSpeeds();
+  lowestAirflows();
+  openLoopFallback();
+  holdsSpeed();
+  minimumDuty();
+  noWindup();
+
+  return testUtils::finish("fansTest");
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// tests for the heater outputs: time-proportioning with minimum on and off times (heaters::SlowPWM), run with a fake clock the way heaterTick() runs it, and bringing on the second heater (heaters::Stager)
+
+#include "logicLibs.hpp"
+#include "../testUtils.hpp"
+
+using namespace heaters;
+
+namespace {
+  constexpr uint16_t DEMAND_MAX = 1000; ///< HEATER_DEMAND_MAX
+  constexpr uint32_t TICK = 50; ///< HEATER_TICK_INTERVAL (ms)
+
+  /// what a run of the heater output did
+  struct Run {
+    uint32_t onTime = 0; ///< ms
+    uint32_t shortestOn = UINT32_MAX; ///< the shortest on period (ms), not counting the last one
+    uint32_t shortestOff = UINT32_MAX; ///< the shortest off period (ms), not counting the first or last one
+    uint32_t switches = 0;
+  };
+
+  /// updates <output> every tick from <start> for <duration> ms, and records what it did
+  Run run(SlowPWM& output, uint32_t start, uint32_t duration) {
+    Run result;
+    bool on = output.update(start);
+    bool first = true;
+    uint32_t switchTime = start;
+
+    for (uint32_t now = start + TICK; now <= start + duration; now += TICK) {
+      if (on) result.onTime += TICK;
+
+      bool nowOn = output.update(now);
+      if (nowOn == on) continue;
+
+      if (on) result.shortestOn = std::min(result.shortestOn, now - switchTime);
+      else if (!first) result.shortestOff = std::min(result.shortestOff, now - switchTime);
+
+      on = nowOn;
+      first = false;
+      switchTime = now;
+      result.switches++;
+    }
+
+    return result;
+  }
+
+  struct Settings {
+    std::atomic<uint16_t> window{5000};
+    std::atomic<uint16_t> minOn{1000};
+    std::atomic<uint16_t> minOff{1000};
+  };
+
+  void averageDuty() {
+    Settings settings;
+    SlowPWM output(&settings.window, &settings.minOn, &settings.minOff, DEMAND_MAX);
+
+    output.setDemand(300);
+    Run result = run(output, 0, 60000);
+    CHECK_NEAR(result.onTime, 18000, 500); // 30% of a minute
+    CHECK(result.shortestOn >= 1000 && result.shortestOff >= 1000);
+    CHECK(output.getTotalOnTime() == result.onTime);
+  }
+
+  void shortDemands() {
+    Settings settings;
+    SlowPWM output(&settings.window, &settings.minOn, &settings.minOff, DEMAND_MAX);
+
+    output.setDemand(100); // 500 ms a window, under the minimum on time, so it is saved up
+    Run low = run(output, 0, 100000);
+    CHECK_NEAR(low.onTime, 10000, 1100);
+    CHECK(low.shortestOn >= 1000);
+
+    output.setDemand(900); // 500 ms off a window, under the minimum off time
+    Run high = run(output, 100000, 100000);
+    CHECK_NEAR(high.onTime, 90000, 1100);
+    CHECK(high.shortestOff >= 1000);
+  }
+
+  void fullAndOff() {
+    Settings settings;
+    SlowPWM output(&settings.window, &settings.minOn, &settings.minOff, DEMAND_MAX);
+
+    output.setDemand(5000); // past the maximum is always on
+    CHECK(output.getDemand() == DEMAND_MAX);
+    Run full = run(output, 0, 20000);
+    CHECK(full.onTime == 20000 && full.switches == 0);
+
+    output.setDemand(0);
+    Run off = run(output, 20000, 20000);
+    CHECK(off.onTime == 0 && off.switches == 0); // off at the first update (it has been on long enough), and stays off
+  }
+
+  void stops() {
+    Settings settings;
+    SlowPWM output(&settings.window, &settings.minOn, &settings.minOff, DEMAND_MAX);
+
+    output.setDemand(500);
+    CHECK(output.update(0)); // on right away, since it has been off since startup
+    CHECK(output.update(TICK)); // one tick in, well under the minimum on time
+
+    output.stop();
+    CHECK(!output.update(2 * TICK)); // but a stop turns it off anyway
+    CHECK(output.getDemand() == 0);
+  }
+
+  void windowChanges() {
+    Settings settings;
+    SlowPWM output(&settings.window, &settings.minOn, &settings.minOff, DEMAND_MAX);
+
+    output.setDemand(250);
+    run(output, 0, 20000);
+
+    settings.window = 10000; // a new window length takes effect without upsetting the average
+    settings.minOn = 6000; // and a minimum on time over half the window is held to half
+    Run result = run(output, 20000, 100000);
+    CHECK_NEAR(result.onTime, 25000, 2000);
+    CHECK(result.shortestOn >= 5000);
+  }
+
+  constexpr uint8_t FRACTION_BITS = 3; ///< TEMP_FRACTION_BITS
+  constexpr uint32_t RISE_TIME = 120000; ///< STAGE2_RISE_TIME (ms)
+
+  void bigErrors() {
+    std::atomic<uint8_t> stageError{8};
+    std::atomic<uint8_t> minRise{0};
+    Stager stager(FRACTION_BITS, DEMAND_MAX, RISE_TIME, &stageError, &minRise);
+
+    CHECK(stager.update(DEMAND_MAX, 10 << FRACTION_BITS, 30 << FRACTION_BITS, 0)); // 10 deg. c. under
+    CHECK(stager.update(DEMAND_MAX, 5 << FRACTION_BITS, 35 << FRACTION_BITS, 1000)); // stays on above half the stage 2 error
+    CHECK(!stager.update(DEMAND_MAX, 3 << FRACTION_BITS, 37 << FRACTION_BITS, 2000)); // and goes off below it
+    CHECK(!stager.update(DEMAND_MAX, 5 << FRACTION_BITS, 35 << FRACTION_BITS, 3000)); // then needs the whole error again
+
+    stageError = 0; // off
+    CHECK(!stager.update(DEMAND_MAX, 50 << FRACTION_BITS, 0, 4000));
+  }
+
+  /// holds the first heater fully on while the temp rises at <tenthsPerMinute>, and returns if stage 2 came on within two rise times
+  bool slowRise(Stager& stager, uint32_t tenthsPerMinute) {
+    int16_t start = 30 << FRACTION_BITS;
+
+    for (uint32_t now = 0; now <= 2 * RISE_TIME; now += 10000) {
+      int16_t measured = start + static_cast<int16_t>((static_cast<int64_t>(tenthsPerMinute) * now << FRACTION_BITS) / 600000);
+      if (stager.update(DEMAND_MAX, (45 << FRACTION_BITS) - measured, measured, now)) return true;
+    }
+
+    return false;
+  }
+
+  void slowRises() {
+    std::atomic<uint8_t> stageError{0};
+    std::atomic<uint8_t> minRise{5}; // half a degree a minute
+    Stager stager(FRACTION_BITS, DEMAND_MAX, RISE_TIME, &stageError, &minRise);
+
+    CHECK(!slowRise(stager, 10)); // a degree a minute is fast enough
+    stager.reset();
+    CHECK(slowRise(stager, 2)); // a fifth of one isn't
+    CHECK(stager.update(DEMAND_MAX, 1, 45 << FRACTION_BITS, 3 * RISE_TIME)); // so stage 2 stays on until the target is reached
+    CHECK(!stager.update(DEMAND_MAX, 0, 45 << FRACTION_BITS, 3 * RISE_TIME + 10000));
+
+    stager.reset();
+    for (uint32_t now = 0; now <= 3 * RISE_TIME; now += 10000) CHECK(!stager.update(DEMAND_MAX - 1, 10 << FRACTION_BITS, 30 << FRACTION_BITS, now)); // a heater that isn't fully on says nothing about how fast it can heat
+  }
+}
+
+int main() {
+  averageDuty();
+  shortDemands();
+  fullAndOff();
+  stops();
+  windowChanges();
+  bigErrors();
+  slowRises();
+
+  return testUtils::finish("heatersTest");
+}
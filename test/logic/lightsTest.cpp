@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// tests for the light logic: fades, patterns, and the lightness curve
+
+#include "logicLibs.hpp"
+#include "../testUtils.hpp"
+
+using namespace lights;
+
+namespace {
+  /// steps a fade until it is done (or <limit> ticks pass), and returns how many ticks it took
+  uint32_t ticksToFinish(FadeStepper& fade, uint32_t limit) {
+    uint32_t ticks = 0;
+    while (!fade.isDone() && ticks < limit) {
+      fade.step();
+      ticks++;
+    }
+    return ticks;
+  }
+
+  void fades() {
+    FadeStepper fade;
+    CHECK(fade.getLevel() == 0);
+    CHECK(fade.isDone());
+    CHECK(!fade.step()); // nothing to do
+
+    fade.start(255, 100); // a full fade over 100 ticks
+    for (int i = 0; i < 50; i++) fade.step();
+    CHECK_NEAR(fade.getLevel(), 127, 1);
+    CHECK_NEAR(ticksToFinish(fade, 1000), 50, 1); // the step is rounded down, so it can take one tick longer
+    CHECK(fade.getLevel() == 255);
+
+    fade.start(204, 100); // a fifth of the range takes a fifth of the time
+    CHECK_NEAR(ticksToFinish(fade, 1000), 20, 1);
+    CHECK(fade.getLevel() == 204);
+
+    fade.start(10, 0); // no fade time jumps on the next tick
+    CHECK(fade.step());
+    CHECK(fade.isDone());
+    CHECK(fade.getLevel() == 10);
+
+    fade.start(11, 1000000); // a fade so slow it moves less than a level per tick still moves
+    uint16_t fineLevel = fade.getFineLevel();
+    for (int i = 0; i < 1000; i++) fade.step();
+    CHECK(fade.getFineLevel() > fineLevel);
+    CHECK(!fade.isDone());
+
+    fade.setLevel(200); // jumping ends the fade
+    CHECK(fade.isDone());
+    CHECK(fade.getLevel() == 200);
+    CHECK(fade.getFineLevel() == (200 << 8));
+
+    fade.setFineLevel(0x1280);
+    CHECK(fade.getLevel() == 0x12);
+    CHECK(fade.getFineLevel() == 0x1280);
+  }
+
+  void lightness() {
+    CHECK(levelToDuty(0) == 0);
+    CHECK(levelToDuty(255 << 8) == 65535);
+    CHECK_NEAR(levelToDuty(128 << 8), 65535 * 0.1859, 20); // level 128 is L* 50.2, which is 18.6% luminance
+
+    bool increasing = true;
+    for (uint32_t fineLevel = 1; fineLevel <= (255 << 8); fineLevel++) {
+      if (levelToDuty(fineLevel) < levelToDuty(fineLevel - 1)) increasing = false;
+    }
+    CHECK(increasing);
+  }
+
+  void patterns() {
+    static const Keyframe pulse[] = {{0, 0}, {100, 255}, {200, 0}};
+    static const Keyframe step[] = {{0, 0}, {50, 0}, {50, 255}, {100, 255}};
+    const Pattern pulsePattern = {pulse, 3};
+    const Pattern stepPattern = {step, 4};
+
+    CHECK(patternLevel(pulsePattern, 0) == 0);
+    CHECK(patternLevel(pulsePattern, 50) == ((255 << 8) / 2));
+    CHECK(patternLevel(pulsePattern, 100) == (255 << 8));
+    CHECK(patternLevel(pulsePattern, 150) == ((255 << 8) / 2));
+    CHECK(patternLevel(pulsePattern, 250) == patternLevel(pulsePattern, 50)); // it loops
+
+    CHECK(patternLevel(stepPattern, 49) == 0);
+    CHECK(patternLevel(stepPattern, 50) == (255 << 8));
+
+    const Pattern empty = {nullptr, 0};
+    CHECK(patternLevel(empty, 10) == 0);
+  }
+}
+
+int main() {
+  fades();
+  lightness();
+  patterns();
+
+  return testUtils::finish("lightsTest");
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// tests for the servo move planning (servos::Trajectory), run against a fake clock
+
+#include "logicLibs.hpp"
+#include "../testUtils.hpp"
+#include <cstdlib>
+
+using namespace servos;
+
+namespace {
+  /// true if the position only ever moves towards the target, and never faster than <maxDegreesPerMs> (allowing a degree for rounding)
+  bool smoothMove(const Trajectory& move, uint32_t start, uint32_t end, float maxDegreesPerMs) {
+    int16_t last = move.getPosition(start);
+    int8_t direction = (move.getTarget() < last) ? -1 : 1;
+
+    for (uint32_t now = start + 10; now <= end; now += 10) {
+      int16_t position = move.getPosition(now);
+      int16_t step = (position - last) * direction;
+      if (step < 0 || step > (maxDegreesPerMs * 10) + 1) return false;
+      last = position;
+    }
+
+    return true;
+  }
+
+  void jumps() {
+    Trajectory move;
+    move.setPosition(90);
+    CHECK(move.getPosition(0) == 90);
+    CHECK(move.getTarget() == 90);
+    CHECK(move.isDone(0));
+
+    move.start(30, 1000, 0, 0); // no speed set jumps straight there
+    CHECK(move.getPosition(1000) == 30);
+    CHECK(move.isDone(1000));
+  }
+
+  void constantSpeed() {
+    Trajectory move;
+    move.setPosition(0);
+    move.start(180, 0, 10, 0); // 10 ms per degree, no acceleration
+
+    CHECK(move.getPosition(0) == 0);
+    CHECK(move.getPosition(450) == 45);
+    CHECK(!move.isDone(1799));
+    CHECK(move.getPosition(1800) == 180);
+    CHECK(move.isDone(1800));
+    CHECK(smoothMove(move, 0, 1800, 0.1f));
+  }
+
+  void trapezoid() {
+    Trajectory move;
+    move.setPosition(0);
+    move.start(180, 0, 10, 200); // cruise at 100 deg./s, reached after 500 ms (and 25 deg.) at 200 deg./s/s
+
+    CHECK(move.getPosition(500) == 25); // done speeding up
+    CHECK(move.getPosition(1150) == 90); // half way, at full speed
+    CHECK(move.getPosition(1800) == 155); // starting to slow down
+    CHECK(!move.isDone(2299));
+    CHECK(move.isDone(2300));
+    CHECK(move.getPosition(2300) == 180);
+    CHECK(smoothMove(move, 0, 2300, 0.1f));
+
+    // speeding up and slowing down mirror each other
+    for (uint32_t t = 0; t <= 500; t += 50) CHECK(move.getPosition(t) == (180 - move.getPosition(2300 - t)));
+  }
+
+  void shortMove() {
+    Trajectory move;
+    move.setPosition(100);
+    move.start(80, 0, 10, 200); // too short to reach full speed: 10 deg. speeding up, 10 slowing down
+
+    CHECK(move.getPosition(316) == 90); // the peak, sqrt(10 / 0.0002) ms in
+    CHECK(!move.isDone(630));
+    CHECK(move.isDone(633));
+    CHECK(move.getPosition(633) == 80);
+    CHECK(smoothMove(move, 0, 633, 0.1f));
+  }
+
+  void retarget() {
+    Trajectory move;
+    move.setPosition(0);
+    move.start(180, 0, 10, 0);
+
+    move.start(0, 900, 10, 0); // turn back half way; the new move starts from where the servo got to
+    CHECK(move.getPosition(900) == 90);
+    CHECK(move.getPosition(1350) == 45);
+    CHECK(move.isDone(1800));
+    CHECK(move.getPosition(1800) == 0);
+  }
+
+  void clockWrap() {
+    Trajectory move;
+    move.setPosition(0);
+    move.start(90, UINT32_MAX - 100, 10, 0); // millis() wraps around during the move
+
+    CHECK(move.getPosition(UINT32_MAX - 100) == 0);
+    CHECK(move.getPosition(399) == 50);
+    CHECK(move.isDone(799));
+    CHECK(move.getPosition(799) == 90);
+  }
+}
+
+int main() {
+  jumps();
+  constantSpeed();
+  trapezoid();
+  shortMove();
+  retarget();
+  clockWrap();
+
+  return testUtils::finish("servosTest");
+}
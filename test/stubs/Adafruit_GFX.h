@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for Adafruit_GFX | pixel drawing goes through writePixel() one pixel at a time, the same as the real library's default text and rectangle code
+
+#pragma once
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {}
+
+    /// the classic 5x7 font, 5 columns per character | empty until a test fills it in (the real one lives in the library's glcdfont.c)
+    inline static uint8_t font[256 * 5] = {0};
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { for (int16_t i = 0; i < h; i++) writePixel(x, y + i, color); }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { for (int16_t i = 0; i < w; i++) writePixel(x + i, y, color); }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color); }
+
+    /// the same per-pixel loop as the real library's drawChar() for the classic font
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+      if ((x >= WIDTH) || (y >= HEIGHT) || ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0)) return;
+
+      for (int8_t i = 0; i < 5; i++) {
+        uint8_t line = font[c * 5 + i];
+        for (int8_t j = 0; j < 8; j++, line >>= 1) {
+          if (line & 1) {
+            if (size == 1) writePixel(x + i, y + j, color);
+            else fillRect(x + i * size, y + j * size, size, size, color);
+
+          } else if (bg != color) {
+            if (size == 1) writePixel(x + i, y + j, bg);
+            else fillRect(x + i * size, y + j * size, size, size, bg);
+          }
+        }
+      }
+
+      if (bg != color) { // opaque text also draws the gap after the character
+        if (size == 1) drawFastVLine(x + 5, y, 8, bg);
+        else fillRect(x + 5 * size, y, size, 8 * size, bg);
+      }
+    }
+
+    size_t write(uint8_t c) override {
+      if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize * 8;
+
+      } else if (c != '\r') {
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+        cursor_x += textsize * 6;
+      }
+
+      return 1;
+    }
+
+    void setTextSize(uint8_t size) { textsize = (size > 0) ? size : 1; }
+    void setTextColor(uint16_t color) { textcolor = textbgcolor = color; }
+    void setTextColor(uint16_t color, uint16_t background) { textcolor = color; textbgcolor = background; }
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    void cp437(bool) {}
+
+    int16_t width() const { return WIDTH; }
+    int16_t height() const { return HEIGHT; }
+
+  protected:
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+    int16_t cursor_x = 0;
+    int16_t cursor_y = 0;
+    uint16_t textcolor = 0xFFFF;
+    uint16_t textbgcolor = 0xFFFF;
+    uint8_t textsize = 1;
+};
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for Adafruit_SSD1306 | keeps the frame buffer in memory, and sends the same I2C writes as the real library, so what reaches the bus can be counted and checked
+
+#pragma once
+
+#include "Adafruit_GFX.h"
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_SETDISPLAYOFFSET 0xD3
+#define SSD1306_SETSTARTLINE 0x40
+#define SSD1306_DEACTIVATE_SCROLL 0x2E
+#define SSD1306_ACTIVATE_SCROLL 0x2F
+#define SSD1306_RIGHT_HORIZONTAL_SCROLL 0x26
+#define SSD1306_LEFT_HORIZONTAL_SCROLL 0x27
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+  public:
+    static constexpr uint16_t WIRE_MAX = 32; ///< the most bytes the library puts in one I2C write (its default when the core doesn't say otherwise)
+    static constexpr uint8_t NORMAL_CONTRAST = 0xCF; ///< the contrast dim(false) goes back to (with the internal charge pump)
+
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t)
+      : Adafruit_GFX(w, h), ssd1306_wire(twi), ssd1306_buffer((w * ((h + 7) / 8)), 0) {}
+
+    bool begin(uint8_t, uint8_t address) {
+      ssd1306_address = address;
+      return true;
+    }
+
+    uint8_t* getBuffer() { return ssd1306_buffer.data(); }
+    void clearDisplay() { std::fill(ssd1306_buffer.begin(), ssd1306_buffer.end(), 0); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+      if ((x < 0) || (x >= WIDTH) || (y < 0) || (y >= HEIGHT)) return;
+
+      uint8_t& column = ssd1306_buffer[x + (y / 8) * WIDTH];
+      switch (color) {
+        case SSD1306_WHITE: column |= (1 << (y & 7)); break;
+        case SSD1306_BLACK: column &= ~(1 << (y & 7)); break;
+        case SSD1306_INVERSE: column ^= (1 << (y & 7)); break;
+      }
+    }
+
+    /// works a byte (8 rows) at a time where it can, like the real library's version
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+      if ((x < 0) || (x >= WIDTH)) return;
+      if (y < 0) { h += y; y = 0; }
+      if ((y + h) > HEIGHT) h = HEIGHT - y;
+
+      while (h > 0) {
+        uint8_t bit = y & 7;
+        uint8_t rows = min(static_cast<int16_t>(8 - bit), h);
+        uint8_t mask = static_cast<uint8_t>(((1 << rows) - 1) << bit);
+        uint8_t& column = ssd1306_buffer[x + (y / 8) * WIDTH];
+
+        switch (color) {
+          case SSD1306_WHITE: column |= mask; break;
+          case SSD1306_BLACK: column &= ~mask; break;
+          case SSD1306_INVERSE: column ^= mask; break;
+        }
+
+        y += rows;
+        h -= rows;
+      }
+    }
+
+    void display() {
+      static const uint8_t dlist1[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+      commandList(dlist1, sizeof(dlist1));
+      command1(WIDTH - 1);
+
+      uint16_t count = ssd1306_buffer.size();
+      const uint8_t* ptr = ssd1306_buffer.data();
+
+      ssd1306_wire->beginTransmission(ssd1306_address);
+      ssd1306_wire->write(0x40);
+      uint16_t bytesOut = 1;
+      while (count--) {
+        if (bytesOut >= WIRE_MAX) {
+          ssd1306_wire->endTransmission();
+          ssd1306_wire->beginTransmission(ssd1306_address);
+          ssd1306_wire->write(0x40);
+          bytesOut = 1;
+        }
+        ssd1306_wire->write(*ptr++);
+        bytesOut++;
+      }
+      ssd1306_wire->endTransmission();
+    }
+
+    void ssd1306_command(uint8_t c) { command1(c); }
+
+    void dim(bool dim) {
+      command1(SSD1306_SETCONTRAST);
+      command1(dim ? 0 : NORMAL_CONTRAST);
+    }
+
+    void invertDisplay(bool i) { command1(i ? 0xA7 : 0xA6); }
+    void startscrollright(uint8_t, uint8_t) {}
+    void stopscroll() { command1(SSD1306_DEACTIVATE_SCROLL); }
+
+  private:
+    TwoWire* ssd1306_wire;
+    uint8_t ssd1306_address = 0x3C;
+    std::vector<uint8_t> ssd1306_buffer;
+
+    void command1(uint8_t c) {
+      ssd1306_wire->beginTransmission(ssd1306_address);
+      ssd1306_wire->write(0x00);
+      ssd1306_wire->write(c);
+      ssd1306_wire->endTransmission();
+    }
+
+    void commandList(const uint8_t* c, uint8_t n) {
+      ssd1306_wire->beginTransmission(ssd1306_address);
+      ssd1306_wire->write(0x00);
+      uint16_t bytesOut = 1;
+      while (n--) {
+        if (bytesOut >= WIRE_MAX) {
+          ssd1306_wire->endTransmission();
+          ssd1306_wire->beginTransmission(ssd1306_address);
+          ssd1306_wire->write(0x00);
+          bytesOut = 1;
+        }
+        ssd1306_wire->write(*c++);
+        bytesOut++;
+      }
+      ssd1306_wire->endTransmission();
+    }
+};
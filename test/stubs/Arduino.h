@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for Arduino.h (Arduino-pico core) | just enough of the API for the firmware's logic and screen code to build and run on a computer
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdarg>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include "api/String.h"
+#include "pico/stdlib.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define FALLING 2
+#define RISING 3
+#define CHANGE 4
+#define LED_BUILTIN 25
+#define PROGMEM
+#define BOOTSEL false
+
+typedef uint8_t pin_size_t;
+
+namespace hostStubs {
+  /**
+  * @brief moves the fake clock behind millis() and micros() forward | it never moves on its own, so runs are repeatable
+  */
+  void advanceMicros(uint64_t microseconds);
+
+  /// the fake clock, in microseconds
+  uint64_t nowMicros();
+}
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void digitalWrite(pin_size_t pin, int value);
+int digitalRead(pin_size_t pin);
+void analogWrite(pin_size_t pin, int value);
+void pinMode(pin_size_t pin, int mode);
+void analogWriteFreq(uint32_t freq);
+void analogWriteRange(uint32_t range);
+void analogWriteResolution(int resolution);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// the same templates as the Arduino-pico core (ArduinoCore-API)
+template<class T, class L> auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template<class T, class L> auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+template<class T, class L, class H> auto constrain(const T& amt, const L& low, const H& high) -> decltype((amt < low) ? low : ((amt > high) ? high : amt)) {
+  return (amt < low) ? low : ((amt > high) ? high : amt);
+}
+
+void attachInterrupt(pin_size_t pin, void (*callback)(), int mode);
+void detachInterrupt(pin_size_t pin);
+inline pin_size_t digitalPinToInterrupt(pin_size_t pin) { return pin; }
+void noInterrupts();
+void interrupts();
+
+/// everything printed is thrown away, so debug messages cost (almost) nothing on the host
+struct SerialStub {
+  void begin(unsigned long) {}
+  operator bool() { return true; }
+  int printf(const char*, ...) { return 0; }
+  size_t print(const char*) { return 0; }
+  size_t print(int) { return 0; }
+  size_t println(int) { return 0; }
+  size_t println(const char*) { return 0; }
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t*, size_t length) { return length; }
+  int available() { return 0; }
+  int read() { return -1; }
+  long parseInt() { return 0; }
+  void setTimeout(unsigned long) {}
+  void flush() {}
+};
+extern SerialStub Serial;
+
+struct RP2040Stub {
+  int cpuid() { return 1; } ///< the screen is drawn by core1
+  void idleOtherCore() {}
+  void resumeOtherCore() {}
+  void reboot() {}
+  int getUsedHeap() { return 0; }
+  int getFreeHeap() { return 0; }
+};
+extern RP2040Stub rp2040;
+
+struct Print {
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t print(const char* str) { size_t n = 0; while (*str) n += write(static_cast<uint8_t>(*str++)); return n; }
+  size_t print(const String& str) { return print(str.c_str()); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(long value) { char text[12]; snprintf(text, sizeof(text), "%ld", value); return print(text); }
+  size_t print(int value) { return print(static_cast<long>(value)); }
+  size_t print(unsigned long value) { char text[12]; snprintf(text, sizeof(text), "%lu", value); return print(text); }
+  size_t print(unsigned value) { return print(static_cast<unsigned long>(value)); }
+};
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for the Arduino-pico Wire library | counts every byte that would go over the bus, and passes finished writes to a listener (a model of the device)
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+
+struct TwoWire {
+  /// called with the address and data of each finished write
+  std::function<void(uint8_t address, const std::vector<uint8_t>& data)> listener;
+
+  uint32_t busBytes = 0; ///< bytes sent, counting the address byte of each write
+  uint32_t transmissions = 0; ///< writes sent (each has its own start and stop condition)
+
+  void setSDA(int) {}
+  void setSCL(int) {}
+  void setClock(uint32_t) {}
+  void begin() {}
+  void begin(uint8_t) {}
+  void end() {}
+
+  void beginTransmission(uint8_t address) {
+    wire_address = address;
+    wire_pending.clear();
+  }
+
+  uint8_t endTransmission(bool = true) {
+    busBytes += 1 + wire_pending.size();
+    transmissions++;
+    if (listener) listener(wire_address, wire_pending);
+    return 0;
+  }
+
+  size_t write(uint8_t data) {
+    wire_pending.push_back(data);
+    return 1;
+  }
+
+  int available() { return 0; }
+  int read() { return -1; }
+  void onRequest(void (*)()) {}
+  void onReceive(void (*)(int)) {}
+
+  void resetCounts() {
+    busBytes = 0;
+    transmissions = 0;
+  }
+
+  private:
+    uint8_t wire_address = 0;
+    std::vector<uint8_t> wire_pending;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for the Arduino-pico String class, backed by std::string | only what the firmware uses
+
+#pragma once
+
+#include <string>
+#include <cstring>
+
+class String {
+  public:
+    String() {}
+    String(const char* str) : string_data(str != nullptr ? str : "") {}
+    String(const String& other) = default;
+    explicit String(char c) : string_data(1, c) {}
+    explicit String(int value) : string_data(std::to_string(value)) {}
+    explicit String(unsigned value) : string_data(std::to_string(value)) {}
+    explicit String(long value) : string_data(std::to_string(value)) {}
+    explicit String(unsigned long value) : string_data(std::to_string(value)) {}
+
+    String& operator=(const String& other) = default;
+    String& operator=(const char* str) { string_data = (str != nullptr ? str : ""); return *this; }
+
+    bool concat(const String& other) { string_data += other.string_data; return true; }
+    bool concat(const char* str) { if (str != nullptr) string_data += str; return true; }
+    String& operator+=(const String& other) { concat(other); return *this; }
+    String& operator+=(const char* str) { concat(str); return *this; }
+    friend String operator+(String a, const String& b) { a.concat(b); return a; }
+    friend String operator+(String a, const char* b) { a.concat(b); return a; }
+
+    const char* c_str() const { return string_data.c_str(); }
+    unsigned length() const { return string_data.length(); }
+    char operator[](unsigned index) const { return (index < string_data.length()) ? string_data[index] : '\0'; }
+    bool operator==(const String& other) const { return string_data == other.string_data; }
+
+  private:
+    std::string string_data;
+};
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for hardware/pwm.h | writes go to a plain struct laid out like the PWM registers, so tests can read back what was set
+
+#pragma once
+
+#include <cstdint>
+#include "hardware/gpio.h"
+
+#define PWM_CHAN_A 0
+#define PWM_CHAN_B 1
+#define NUM_PWM_SLICES 8
+#define PWM_CH0_CC_A_LSB 0
+#define PWM_CH0_CC_B_LSB 16
+#define PWM_CH0_CSR_A_INV_BITS 0x4u
+#define PWM_CH0_CSR_B_INV_BITS 0x8u
+
+enum pwm_clkdiv_mode { PWM_DIV_FREE_RUNNING, PWM_DIV_B_HIGH, PWM_DIV_B_RISING, PWM_DIV_B_FALLING };
+
+struct pwm_config {
+  uint32_t csr, div, top;
+};
+
+struct pwm_slice_hw_t {
+  volatile uint32_t csr, div, ctr, cc, top;
+};
+
+struct pwm_hw_t {
+  pwm_slice_hw_t slice[NUM_PWM_SLICES];
+  volatile uint32_t en, intr, inte, intf, ints;
+};
+
+inline pwm_hw_t pwmRegisters = {};
+inline pwm_hw_t* pwm_hw = &pwmRegisters;
+
+inline void hw_write_masked(volatile uint32_t* addr, uint32_t values, uint32_t write_mask) { *addr = (*addr & ~write_mask) | (values & write_mask); }
+
+inline uint32_t pwm_gpio_to_slice_num(unsigned gpio) { return (gpio >> 1) & 7; }
+inline uint32_t pwm_gpio_to_channel(unsigned gpio) { return gpio & 1; }
+
+inline pwm_config pwm_get_default_config() { return {0, 1 << 4, 0xFFFF}; }
+inline void pwm_config_set_clkdiv(pwm_config* c, float div) { c->div = static_cast<uint32_t>(div * 16); }
+inline void pwm_config_set_clkdiv_int_frac(pwm_config* c, uint8_t integer, uint8_t fract) { c->div = (integer << 4) | fract; }
+inline void pwm_config_set_wrap(pwm_config* c, uint16_t wrap) { c->top = wrap; }
+inline void pwm_config_set_clkdiv_mode(pwm_config*, pwm_clkdiv_mode) {}
+inline void pwm_config_set_output_polarity(pwm_config*, bool, bool) {}
+
+inline void pwm_init(uint32_t slice, pwm_config* c, bool start) {
+  pwm_hw->slice[slice].csr = c->csr | (start ? 1 : 0);
+  pwm_hw->slice[slice].div = c->div;
+  pwm_hw->slice[slice].top = c->top;
+  pwm_hw->slice[slice].cc = 0;
+  pwm_hw->slice[slice].ctr = 0;
+}
+
+inline void pwm_set_chan_level(uint32_t slice, uint32_t channel, uint16_t level) {
+  hw_write_masked(&pwm_hw->slice[slice].cc, static_cast<uint32_t>(level) << (channel ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB), channel ? 0xFFFF0000u : 0x0000FFFFu);
+}
+inline void pwm_set_gpio_level(unsigned gpio, uint16_t level) { pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level); }
+inline void pwm_set_enabled(uint32_t slice, bool enabled) { hw_write_masked(&pwm_hw->slice[slice].csr, enabled ? 1 : 0, 1); }
+inline void pwm_set_mask_enabled(uint32_t mask) { pwm_hw->en = mask; }
+inline void pwm_set_irq_enabled(uint32_t slice, bool enabled) { hw_write_masked(&pwm_hw->inte, (enabled ? 1u : 0u) << slice, 1u << slice); }
+inline void pwm_clear_irq(uint32_t slice) { pwm_hw->intr &= ~(1u << slice); }
+inline uint32_t pwm_get_irq_status_mask() { return pwm_hw->ints; }
+inline void pwm_set_wrap(uint32_t slice, uint16_t wrap) { pwm_hw->slice[slice].top = wrap; }
+inline void pwm_set_clkdiv(uint32_t slice, float div) { pwm_hw->slice[slice].div = static_cast<uint32_t>(div * 16); }
+inline void pwm_set_clkdiv_int_frac(uint32_t slice, uint8_t integer, uint8_t fract) { pwm_hw->slice[slice].div = (integer << 4) | fract; }
+inline uint16_t pwm_get_counter(uint32_t slice) { return static_cast<uint16_t>(pwm_hw->slice[slice].ctr); }
+inline void pwm_set_counter(uint32_t slice, uint16_t count) { pwm_hw->slice[slice].ctr = count; }
+inline void pwm_set_output_polarity(uint32_t, bool, bool) {}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for hardware/sync.h
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+inline uint32_t save_and_disable_interrupts() { return 0; }
+inline void restore_interrupts(uint32_t) {}
+
+typedef volatile uint32_t spin_lock_t;
+
+inline spin_lock_t hostSpinLock = 0; ///< every lock number gives this one
+
+inline unsigned next_striped_spin_lock_num() { return 16; }
+inline spin_lock_t* spin_lock_instance(unsigned) { return &hostSpinLock; }
+inline uint32_t spin_lock_blocking(spin_lock_t* lock) { if (*lock) abort(); *lock = 1; return 0; } // would deadlock on the RP2040
+inline void spin_unlock(spin_lock_t* lock, uint32_t) { if (!*lock) abort(); *lock = 0; }
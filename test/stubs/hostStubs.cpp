@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// definitions for the host stand-ins: the global objects, the fake clock, and the pin functions
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <EEPROM.h>
+
+SerialStub Serial;
+RP2040Stub rp2040;
+TwoWire Wire;
+TwoWire Wire1;
+EEPROMClass EEPROM;
+
+namespace {
+  uint64_t fakeMicros = 0; ///< the fake clock behind millis() and micros()
+  int pinStates[32] = {0}; ///< the last value written to each pin
+}
+
+namespace hostStubs {
+  void advanceMicros(uint64_t microseconds) { fakeMicros += microseconds; }
+  uint64_t nowMicros() { return fakeMicros; }
+}
+
+uint32_t millis() { return static_cast<uint32_t>(fakeMicros / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(fakeMicros); }
+void delay(uint32_t ms) { fakeMicros += static_cast<uint64_t>(ms) * 1000; }
+void delayMicroseconds(uint32_t us) { fakeMicros += us; }
+
+void digitalWrite(pin_size_t pin, int value) { if (pin < 32) pinStates[pin] = value; }
+int digitalRead(pin_size_t pin) { return (pin < 32) ? pinStates[pin] : 0; }
+void analogWrite(pin_size_t, int) {}
+void pinMode(pin_size_t, int) {}
+void analogWriteFreq(uint32_t) {}
+void analogWriteRange(uint32_t) {}
+void analogWriteResolution(int) {}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) { return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin; }
+
+void attachInterrupt(pin_size_t, void (*)(), int) {}
+void detachInterrupt(pin_size_t) {}
+void noInterrupts() {}
+void interrupts() {}
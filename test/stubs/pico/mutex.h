@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for pico/mutex.h | everything runs on one thread, so the mutexes only check that they are used in pairs
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+struct mutex_t {
+  bool locked = false;
+};
+
+inline void mutex_init(mutex_t* mtx) { mtx->locked = false; }
+inline void mutex_enter_blocking(mutex_t* mtx) { if (mtx->locked) abort(); mtx->locked = true; } // would deadlock on the RP2040
+inline bool mutex_try_enter(mutex_t* mtx, uint32_t*) { if (mtx->locked) return false; mtx->locked = true; return true; }
+inline void mutex_exit(mutex_t* mtx) { if (!mtx->locked) abort(); mtx->locked = false; }
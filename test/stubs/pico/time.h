@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// host stand-in for pico/time.h | alarms and repeating timers are accepted but never fire, tests call the callbacks themselves
+
+#pragma once
+
+#include <cstdint>
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void* user_data);
+
+struct repeating_timer {
+  int64_t delay_us;
+  void* user_data;
+};
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer* rt);
+
+inline alarm_id_t add_alarm_in_us(uint64_t, alarm_callback_t, void*, bool) { return 1; }
+inline alarm_id_t add_alarm_in_ms(uint32_t, alarm_callback_t, void*, bool) { return 1; }
+inline bool cancel_alarm(alarm_id_t) { return true; }
+inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t, void* user_data, repeating_timer* out) { out->delay_us = delay_ms * 1000; out->user_data = user_data; return true; }
+inline bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t, void* user_data, repeating_timer* out) { out->delay_us = delay_us; out->user_data = user_data; return true; }
+inline bool cancel_repeating_timer(repeating_timer*) { return true; }
+
+namespace hostStubs {
+  uint64_t nowMicros();
+}
+
+inline uint64_t time_us_64() { return hostStubs::nowMicros(); }
+inline uint32_t time_us_32() { return static_cast<uint32_t>(hostStubs::nowMicros()); }
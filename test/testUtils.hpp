@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024-2025 Dalen Hardy
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// the checks shared by the host tests | each failed check is printed and counted, and the test's main() returns the count
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace testUtils {
+  inline int failures = 0; ///< how many checks have failed so far
+
+  inline void check(bool condition, const char* expression, const char* file, int line) {
+    if (condition) return;
+    failures++;
+    printf("FAILED: %s (%s:%d)\n", expression, file, line);
+  }
+
+  inline void checkNear(double value, double expected, double tolerance, const char* expression, const char* file, int line) {
+    if ((value >= (expected - tolerance)) && (value <= (expected + tolerance))) return;
+    failures++;
+    printf("FAILED: %s = %g, expected %g +/- %g (%s:%d)\n", expression, value, expected, tolerance, file, line);
+  }
+
+  /// returns the value to exit with, after saying how it went
+  inline int finish(const char* testName) {
+    if (failures == 0) printf("%s: all checks passed\n", testName);
+    else printf("%s: %d check(s) failed\n", testName, failures);
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+}
+
+#define CHECK(condition) testUtils::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(value, expected, tolerance) testUtils::checkNear((value), (expected), (tolerance), #value, __FILE__, __LINE__)